@@ -0,0 +1,383 @@
+#pragma once
+
+// Kernels behind find_unknown_batch(), written once against a small SIMD "pack" interface.
+// batch_solver.cpp instantiates them for scalar and SSE2, batch_solver_avx2.cpp (built with -mavx2) for AVX2.
+// Everything lives in an anonymous namespace so the AVX2 build of a helper can never be picked
+// by the linker for the other translation units.
+#include "batch_solver.hpp"
+#include "solver_cases.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// --- Packs ---
+// Every pack holds `width` doubles; masks are packs where every bit of a lane is set (true) or clear (false)
+// zero_lanes() returns a bitmask with bit k set when lane k is zero
+
+struct pack_scalar{
+    static constexpr std::size_t width {1};
+    double v;
+
+    static pack_scalar set(double x) { return {x}; }
+    static pack_scalar load(const double *p) { return {*p}; }
+    static pack_scalar gather(const double *base, const std::uint16_t *lanes) { return {base[lanes[0]]}; }
+    void store(double *p) const { *p = v; }
+
+    friend pack_scalar operator-(pack_scalar a) { return {-a.v}; }
+    friend pack_scalar operator+(pack_scalar a, pack_scalar b) { return {a.v + b.v}; }
+    friend pack_scalar operator-(pack_scalar a, pack_scalar b) { return {a.v - b.v}; }
+    friend pack_scalar operator*(pack_scalar a, pack_scalar b) { return {a.v * b.v}; }
+    friend pack_scalar operator/(pack_scalar a, pack_scalar b) { return {a.v / b.v}; }
+    friend pack_scalar sqrt(pack_scalar a) { return {std::sqrt(a.v)}; }
+    friend pack_scalar abs(pack_scalar a) { return {std::fabs(a.v)}; }
+
+    // Masks are stored as 1.0 / 0.0 for the scalar pack
+    friend pack_scalar equal(pack_scalar a, pack_scalar b) { return {a.v == b.v ? 1.0 : 0.0}; }
+    friend pack_scalar not_equal(pack_scalar a, pack_scalar b) { return {a.v != b.v ? 1.0 : 0.0}; }
+    friend pack_scalar greater(pack_scalar a, pack_scalar b) { return {a.v > b.v ? 1.0 : 0.0}; }
+    friend pack_scalar mask_and(pack_scalar a, pack_scalar b) { return {(a.v != 0.0 && b.v != 0.0) ? 1.0 : 0.0}; }
+    friend pack_scalar select(pack_scalar mask, pack_scalar a, pack_scalar b) { return mask.v != 0.0 ? a : b; }
+    friend pack_scalar negate_if(pack_scalar mask, pack_scalar a) { return {mask.v != 0.0 ? -a.v : a.v}; }
+    friend bool any(pack_scalar mask) { return mask.v != 0.0; }
+    friend int zero_lanes(pack_scalar a) { return a.v == 0.0; }
+
+    // Mask of the lanes where the (integer valued) lane has the given bit set
+    friend pack_scalar bit_set(pack_scalar a, int bit) { return {(static_cast<std::int64_t>(a.v) & bit) != 0 ? 1.0 : 0.0}; }
+};
+
+#if defined(__SSE2__)
+struct pack_sse2{
+    static constexpr std::size_t width {2};
+    __m128d v;
+
+    static pack_sse2 set(double x) { return {_mm_set1_pd(x)}; }
+    static pack_sse2 load(const double *p) { return {_mm_loadu_pd(p)}; }
+    static pack_sse2 gather(const double *base, const std::uint16_t *lanes) { return {_mm_set_pd(base[lanes[1]], base[lanes[0]])}; }
+    void store(double *p) const { _mm_storeu_pd(p, v); }
+
+    friend pack_sse2 operator-(pack_sse2 a) { return {_mm_xor_pd(a.v, _mm_set1_pd(-0.0))}; }
+    friend pack_sse2 operator+(pack_sse2 a, pack_sse2 b) { return {_mm_add_pd(a.v, b.v)}; }
+    friend pack_sse2 operator-(pack_sse2 a, pack_sse2 b) { return {_mm_sub_pd(a.v, b.v)}; }
+    friend pack_sse2 operator*(pack_sse2 a, pack_sse2 b) { return {_mm_mul_pd(a.v, b.v)}; }
+    friend pack_sse2 operator/(pack_sse2 a, pack_sse2 b) { return {_mm_div_pd(a.v, b.v)}; }
+    friend pack_sse2 sqrt(pack_sse2 a) { return {_mm_sqrt_pd(a.v)}; }
+    friend pack_sse2 abs(pack_sse2 a) { return {_mm_andnot_pd(_mm_set1_pd(-0.0), a.v)}; }
+
+    friend pack_sse2 equal(pack_sse2 a, pack_sse2 b) { return {_mm_cmpeq_pd(a.v, b.v)}; }
+    friend pack_sse2 not_equal(pack_sse2 a, pack_sse2 b) { return {_mm_cmpneq_pd(a.v, b.v)}; }
+    friend pack_sse2 greater(pack_sse2 a, pack_sse2 b) { return {_mm_cmpgt_pd(a.v, b.v)}; }
+    friend pack_sse2 mask_and(pack_sse2 a, pack_sse2 b) { return {_mm_and_pd(a.v, b.v)}; }
+    friend pack_sse2 select(pack_sse2 mask, pack_sse2 a, pack_sse2 b) {
+        return {_mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v))};
+    }
+    friend pack_sse2 negate_if(pack_sse2 mask, pack_sse2 a) { return {_mm_xor_pd(a.v, _mm_and_pd(mask.v, _mm_set1_pd(-0.0)))}; }
+    friend bool any(pack_sse2 mask) { return _mm_movemask_pd(mask.v) != 0; }
+    friend int zero_lanes(pack_sse2 a) { return _mm_movemask_pd(_mm_cmpeq_pd(a.v, _mm_setzero_pd())); }
+
+    friend pack_sse2 bit_set(pack_sse2 a, int bit) {
+        __m128i bits = _mm_and_si128(_mm_cvtpd_epi32(a.v), _mm_set1_epi32(bit));
+        return {_mm_cmpneq_pd(_mm_cvtepi32_pd(bits), _mm_setzero_pd())};
+    }
+};
+#endif
+
+#if defined(__AVX2__)
+struct pack_avx2{
+    static constexpr std::size_t width {4};
+    __m256d v;
+
+    static pack_avx2 set(double x) { return {_mm256_set1_pd(x)}; }
+    static pack_avx2 load(const double *p) { return {_mm256_loadu_pd(p)}; }
+    static pack_avx2 gather(const double *base, const std::uint16_t *lanes) {
+        return {_mm256_i32gather_pd(base, _mm_set_epi32(lanes[3], lanes[2], lanes[1], lanes[0]), 8)};
+    }
+    void store(double *p) const { _mm256_storeu_pd(p, v); }
+
+    friend pack_avx2 operator-(pack_avx2 a) { return {_mm256_xor_pd(a.v, _mm256_set1_pd(-0.0))}; }
+    friend pack_avx2 operator+(pack_avx2 a, pack_avx2 b) { return {_mm256_add_pd(a.v, b.v)}; }
+    friend pack_avx2 operator-(pack_avx2 a, pack_avx2 b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend pack_avx2 operator*(pack_avx2 a, pack_avx2 b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend pack_avx2 operator/(pack_avx2 a, pack_avx2 b) { return {_mm256_div_pd(a.v, b.v)}; }
+    friend pack_avx2 sqrt(pack_avx2 a) { return {_mm256_sqrt_pd(a.v)}; }
+    friend pack_avx2 abs(pack_avx2 a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+
+    friend pack_avx2 equal(pack_avx2 a, pack_avx2 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)}; }
+    friend pack_avx2 not_equal(pack_avx2 a, pack_avx2 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_NEQ_UQ)}; }
+    friend pack_avx2 greater(pack_avx2 a, pack_avx2 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)}; }
+    friend pack_avx2 mask_and(pack_avx2 a, pack_avx2 b) { return {_mm256_and_pd(a.v, b.v)}; }
+    friend pack_avx2 select(pack_avx2 mask, pack_avx2 a, pack_avx2 b) { return {_mm256_blendv_pd(b.v, a.v, mask.v)}; }
+    friend pack_avx2 negate_if(pack_avx2 mask, pack_avx2 a) { return {_mm256_xor_pd(a.v, _mm256_and_pd(mask.v, _mm256_set1_pd(-0.0)))}; }
+    friend bool any(pack_avx2 mask) { return _mm256_movemask_pd(mask.v) != 0; }
+    friend int zero_lanes(pack_avx2 a) { return _mm256_movemask_pd(_mm256_cmp_pd(a.v, _mm256_setzero_pd(), _CMP_EQ_OQ)); }
+
+    friend pack_avx2 bit_set(pack_avx2 a, int bit) {
+        __m128i bits = _mm_and_si128(_mm256_cvtpd_epi32(a.v), _mm_set1_epi32(bit));
+        return {_mm256_cmp_pd(_mm256_cvtepi32_pd(bits), _mm256_setzero_pd(), _CMP_NEQ_UQ)};
+    }
+};
+#endif
+
+// --- Trigonometry ---
+// sin and cos of the same argument, reduced by pi/2 (Cody-Waite) and evaluated with the fdlibm kernels.
+// Valid for |x| < 2^20 * pi/2, which covers every launch angle the simulator accepts.
+
+template <typename P>
+P round_to_integer(P x){
+    // Adding and removing 1.5 * 2^52 rounds to the nearest integer for |x| < 2^51
+    const P magic = P::set(6755399441055744.0);
+    return (x + magic) - magic;
+}
+
+template <typename P>
+void pack_sincos(P x, P &sin_x, P &cos_x){
+    const P quadrant = round_to_integer(x * P::set(6.36619772367581382433e-01)); // x * 2/pi
+    P r = x - quadrant * P::set(1.57079632673412561417e+00);
+    r = r - quadrant * P::set(6.07710050630396597660e-11);
+    r = r - quadrant * P::set(2.02226624879595063154e-21);
+
+    const P z = r * r;
+    const P sin_poly = P::set(-1.66666666666666324348e-01) + z * (P::set(8.33333333332248946124e-03) + z * (P::set(-1.98412698298579493134e-04) +
+                       z * (P::set(2.75573137070700676789e-06) + z * (P::set(-2.50507602534068634195e-08) + z * P::set(1.58969099521155010221e-10)))));
+    const P cos_poly = P::set(4.16666666666666019037e-02) + z * (P::set(-1.38888888888741095749e-03) + z * (P::set(2.48015872894767294178e-05) +
+                       z * (P::set(-2.75573143513906633035e-07) + z * (P::set(2.08757232129817482790e-09) + z * P::set(-1.13596475577881948265e-11)))));
+    const P sin_r = r + (r * z) * sin_poly;
+    const P cos_r = (P::set(1.0) - P::set(0.5) * z) + (z * z) * cos_poly;
+
+    // Odd quadrants swap sin and cos, the sign follows the quadrant
+    const P swap = bit_set(quadrant, 1);
+    sin_x = negate_if(bit_set(quadrant, 2), select(swap, cos_r, sin_r));
+    cos_x = negate_if(bit_set(quadrant + P::set(1.0), 2), select(swap, sin_r, cos_r));
+}
+
+// --- Case selection ---
+// A lane is classified by its unknown mask (see solver_cases.hpp) plus one bit for launches from the
+// ground, only those go through the cases
+
+const unsigned LAUNCH_FROM_GROUND {UNKNOWN_MASKS};
+
+struct lane_case_table{
+    std::uint8_t case_of[2 * UNKNOWN_MASKS];
+    // Byte k of spread[bits] is bit k of bits, turns per-column lane masks into per-lane column masks
+    std::uint32_t spread[16];
+
+    constexpr lane_case_table(): case_of{}, spread{} {
+        for (unsigned index = 0; index < 2 * UNKNOWN_MASKS; index++)
+            case_of[index] = (index & LAUNCH_FROM_GROUND) ? CASE_LOOKUP.case_of[index & (UNKNOWN_MASKS - 1)] : 0;
+        for (std::uint32_t bits = 0; bits < 16; bits++)
+            spread[bits] = (bits & 1) | ((bits >> 1) & 1) << 8 | ((bits >> 2) & 1) << 16 | ((bits >> 3) & 1) << 24;
+    }
+};
+constexpr lane_case_table CASE_TABLE {};
+
+// --- Block solver ---
+
+const std::size_t BLOCK_LANES {1024}; // Lanes per block, keeps the scratch columns in L1/L2
+
+struct block_scratch{
+    alignas(64) double sin_theta[BLOCK_LANES];
+    alignas(64) double cos_theta[BLOCK_LANES];
+    alignas(64) double solved[BLOCK_LANES]; // 1 for lanes that went through a case, 0 for lanes left untouched
+    std::uint8_t case_of_lane[BLOCK_LANES];
+    std::uint16_t lanes_by_case[BLOCK_LANES];
+};
+
+template <typename P>
+case_values<P> load_lanes(const ScenarioColumns &c, const block_scratch &scratch, std::size_t lane){
+    return {P::load(c.v_initial + lane), P::load(c.v_final + lane), P::load(c.acc + lane), P::load(c.time + lane),
+            P::load(c.max_height + lane), P::load(c.range + lane), P::load(scratch.sin_theta + lane), P::load(scratch.cos_theta + lane)};
+}
+
+template <typename P>
+void store_lanes(const ScenarioColumns &c, const case_values<P> &l, std::size_t lane){
+    l.v_initial.store(c.v_initial + lane); l.v_final.store(c.v_final + lane); l.acc.store(c.acc + lane);
+    l.time.store(c.time + lane); l.max_height.store(c.max_height + lane); l.range.store(c.range + lane);
+}
+
+// Solves `length` neighbouring lanes (a multiple of the pack width) that all fall into CASE
+template <int CASE, typename P>
+void solve_run(const ScenarioColumns &c, const block_scratch &scratch, std::size_t first, std::size_t length){
+    for (std::size_t lane = first; lane < first + length; lane += P::width){
+        case_values<P> l = load_lanes<P>(c, scratch, lane);
+        solve_case<CASE>(l);
+        store_lanes(c, l, lane);
+    }
+}
+
+// Gathers the scattered lanes listed in `lanes` pack by pack, solves them as CASE and scatters the results back
+template <int CASE, typename P>
+void solve_group(const ScenarioColumns &c, const block_scratch &scratch, const std::uint16_t *lanes, std::size_t lane_count){
+    constexpr std::size_t W = P::width;
+    alignas(64) double out[6][W];
+
+    for (std::size_t first = 0; first < lane_count; first += W){
+        const std::size_t n = lane_count - first < W ? lane_count - first : W;
+
+        // Pad a partial pack with its first lane, the padding is never written back
+        std::uint16_t pack_lanes[W];
+        for (std::size_t k = 0; k < W; k++)
+            pack_lanes[k] = lanes[first + (k < n ? k : 0)];
+
+        case_values<P> l {P::gather(c.v_initial, pack_lanes), P::gather(c.v_final, pack_lanes), P::gather(c.acc, pack_lanes),
+                          P::gather(c.time, pack_lanes), P::gather(c.max_height, pack_lanes), P::gather(c.range, pack_lanes),
+                          P::gather(scratch.sin_theta, pack_lanes), P::gather(scratch.cos_theta, pack_lanes)};
+        solve_case<CASE>(l);
+        l.v_initial.store(out[0]); l.v_final.store(out[1]); l.acc.store(out[2]); l.time.store(out[3]);
+        l.max_height.store(out[4]); l.range.store(out[5]);
+
+        for (std::size_t k = 0; k < n; k++){
+            const std::size_t lane = pack_lanes[k];
+            c.v_initial[lane] = out[0][k]; c.v_final[lane] = out[1][k]; c.acc[lane] = out[2][k]; c.time[lane] = out[3][k];
+            c.max_height[lane] = out[4][k]; c.range[lane] = out[5][k];
+        }
+    }
+}
+
+// Kernels indexed by case, case 0 ("no case applies") leaves the lanes untouched
+template <typename P>
+struct case_solvers{
+    using run_solver = void (*)(const ScenarioColumns &, const block_scratch &, std::size_t, std::size_t);
+    using group_solver = void (*)(const ScenarioColumns &, const block_scratch &, const std::uint16_t *, std::size_t);
+    run_solver run[CASE_COUNT];
+    group_solver group[CASE_COUNT];
+};
+
+template <typename P, int... CASES>
+constexpr case_solvers<P> make_case_solvers(std::integer_sequence<int, CASES...>){
+    return {{&solve_run<CASES, P>...}, {&solve_group<CASES, P>...}};
+}
+
+// Solves at most BLOCK_LANES lanes, the columns are already offset to the start of the block
+template <typename P>
+void solve_block(const ScenarioColumns &c, block_scratch &scratch){
+    static constexpr case_solvers<P> SOLVERS = make_case_solvers<P>(std::make_integer_sequence<int, CASE_COUNT>{});
+    constexpr std::size_t W = P::width;
+    const std::size_t count = c.count;
+    const std::size_t packed = count - count % W;
+
+    // 1. Normalize the vector inputs, find sin/cos of the launch angle and classify every lane (contiguous, fully vectorized)
+    auto normalize = [&](auto pack_tag, std::size_t i){
+        using Q = decltype(pack_tag);
+        const Q qzero = Q::set(0.0), qone = Q::set(1.0);
+        const Q y_initial = Q::load(c.y_initial + i);
+        const Q ground = equal(y_initial, qzero);
+        Q sin_theta, cos_theta;
+        pack_sincos(Q::load(c.angle + i) * Q::set(M_PI / 180.0), sin_theta, cos_theta);
+
+        Q v_initial = Q::load(c.v_initial + i), v_final = Q::load(c.v_final + i);
+        const Q vii = Q::load(c.v_initial_i_component + i), vfi = Q::load(c.v_final_i_component + i);
+        const Q initial_components = mask_and(ground, not_equal(vii, qzero));
+        const Q from_components = mask_and(ground, not_equal(vfi, qzero));
+        if (any(initial_components)){
+            const Q vij = Q::load(c.v_initial_j_component + i);
+            v_initial = select(initial_components, sqrt(vii * vii + vij * vij), v_initial);
+            v_initial.store(c.v_initial + i);
+        }
+        if (any(from_components)){
+            const Q vfj = Q::load(c.v_final_j_component + i);
+            v_final = select(from_components, sqrt(vfi * vfi + vfj * vfj), v_final);
+            v_final.store(c.v_final + i);
+
+            // sin/cos(atan(a)) without the atan: a / sqrt(1 + a^2) and 1 / sqrt(1 + a^2)
+            const Q slope = abs(vfj / vfi);
+            const Q steep = greater(slope, Q::set(1e150));
+            const Q inverse_length = qone / sqrt(qone + slope * slope);
+            sin_theta = select(from_components, select(steep, qone, slope * inverse_length), sin_theta);
+            cos_theta = select(from_components, select(steep, qone / slope, inverse_length), cos_theta);
+        }
+
+        // Height lanes are masked out here, find_unknown_batch() solves them afterwards with the height solver
+        select(ground, sin_theta, qzero).store(scratch.sin_theta + i);
+        select(ground, cos_theta, qone).store(scratch.cos_theta + i);
+
+        // Byte k of `zero` holds the zero mask of lane k
+        // The shifts match the UnknownBit values
+        const std::uint32_t zero = CASE_TABLE.spread[zero_lanes(v_initial)] | CASE_TABLE.spread[zero_lanes(v_final)] << 1 |
+                                   CASE_TABLE.spread[zero_lanes(Q::load(c.acc + i))] << 2 | CASE_TABLE.spread[zero_lanes(Q::load(c.time + i))] << 3 |
+                                   CASE_TABLE.spread[zero_lanes(Q::load(c.max_height + i))] << 4 | CASE_TABLE.spread[zero_lanes(Q::load(c.range + i))] << 5 |
+                                   CASE_TABLE.spread[zero_lanes(y_initial)] << 6;
+        for (std::size_t k = 0; k < Q::width; k++){
+            const std::uint8_t lane_case = CASE_TABLE.case_of[(zero >> (8 * k)) & 0x7f];
+            scratch.case_of_lane[i + k] = lane_case;
+            scratch.solved[i + k] = lane_case != 0 ? 1.0 : 0.0;
+            if (c.status != nullptr) // Launches from a height are solved after the kernels, see find_unknown_batch()
+                c.status[i + k] = lane_case != 0 ? SolveStatus::SOLVED : SolveStatus::UNSUPPORTED_KNOWN_SET;
+        }
+    };
+    for (std::size_t i = 0; i < packed; i += W)
+        normalize(P{}, i);
+    for (std::size_t i = packed; i < count; i++)
+        normalize(pack_scalar{}, i);
+
+    // 2. Runs of neighbouring lanes with the same case are solved in place, the rest is collected for gathering
+    std::uint16_t leftover[BLOCK_LANES];
+    std::size_t leftover_count {0};
+    for (std::size_t i = 0; i < count;){
+        const std::uint8_t run_case = scratch.case_of_lane[i];
+        std::size_t end = i + 1;
+        while (end < count && scratch.case_of_lane[end] == run_case)
+            end++;
+
+        const std::size_t direct = run_case != 0 ? (end - i) - (end - i) % W : 0;
+        if (direct > 0)
+            SOLVERS.run[run_case](c, scratch, i, direct);
+        if (run_case != 0){
+            for (std::size_t lane = i + direct; lane < end; lane++)
+                leftover[leftover_count++] = static_cast<std::uint16_t>(lane);
+        }
+        i = end;
+    }
+
+    // 3. Group the leftover lanes by case (counting sort) and solve every group with its own kernel
+    if (leftover_count > 0){
+        std::uint16_t case_start[CASE_COUNT + 1] {}, next_slot[CASE_COUNT];
+        for (std::size_t k = 0; k < leftover_count; k++)
+            case_start[scratch.case_of_lane[leftover[k]] + 1]++;
+        for (int k = 0; k < CASE_COUNT; k++){
+            case_start[k + 1] = static_cast<std::uint16_t>(case_start[k + 1] + case_start[k]);
+            next_slot[k] = case_start[k];
+        }
+        for (std::size_t k = 0; k < leftover_count; k++)
+            scratch.lanes_by_case[next_slot[scratch.case_of_lane[leftover[k]]]++] = leftover[k];
+
+        for (int k = 1; k < CASE_COUNT; k++){
+            if (case_start[k + 1] > case_start[k])
+                SOLVERS.group[k](c, scratch, scratch.lanes_by_case + case_start[k], case_start[k + 1] - case_start[k]);
+        }
+    }
+
+    // 4. Values derived for every solved lane (contiguous, fully vectorized)
+    auto finish = [&](auto pack_tag, std::size_t i){
+        using Q = decltype(pack_tag);
+        const Q solved = not_equal(Q::load(scratch.solved + i), Q::set(0.0));
+        const Q abs_max_height = Q::load(c.y_initial + i) + Q::load(c.max_height + i);
+        const Q apex_time = (Q::set(-1.0) * Q::load(c.v_initial + i) * Q::load(scratch.sin_theta + i)) / Q::load(c.acc + i);
+        select(solved, abs_max_height, Q::load(c.abs_max_height + i)).store(c.abs_max_height + i);
+        select(solved, apex_time, Q::load(c.apex_time + i)).store(c.apex_time + i);
+    };
+    for (std::size_t i = 0; i < packed; i += W)
+        finish(P{}, i);
+    for (std::size_t i = packed; i < count; i++)
+        finish(pack_scalar{}, i);
+}
+
+// Entry point for one instruction set
+template <typename P>
+void solve_columns(const ScenarioColumns &columns){
+    block_scratch scratch;
+    for (std::size_t begin = 0; begin < columns.count; begin += BLOCK_LANES){
+        const std::size_t length = columns.count - begin < BLOCK_LANES ? columns.count - begin : BLOCK_LANES;
+        solve_block<P>(columns.slice(begin, length), scratch);
+    }
+}
+
+} // namespace
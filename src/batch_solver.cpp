@@ -0,0 +1,184 @@
+#include "batch_solver.hpp"
+#include "batch_kernels.hpp"
+
+#if defined(KINEMATICS_HAVE_AVX2_KERNEL)
+// Compiled with AVX2 enabled in batch_solver_avx2.cpp, only called after the CPU check below
+void find_unknown_batch_avx2(const ScenarioColumns &columns);
+#endif
+
+ScenarioColumns ScenarioColumns::slice(std::size_t begin, std::size_t length) const {
+    ScenarioColumns view {*this};
+    view.count = length;
+    for (double **column : {&view.y_initial, &view.v_initial, &view.v_final, &view.acc, &view.time, &view.max_height, &view.abs_max_height,
+                            &view.range, &view.angle, &view.v_initial_i_component, &view.v_initial_j_component, &view.v_final_i_component,
+                            &view.v_final_j_component, &view.apex_time})
+        *column += begin;
+    if (view.status != nullptr)
+        view.status += begin;
+    return view;
+}
+
+double *ScenarioColumns::column(Parameter parameter) const {
+    switch (parameter){
+        case Parameter::V_INITIAL_I_COMPONENT: return v_initial_i_component;
+        case Parameter::V_INITIAL_J_COMPONENT: return v_initial_j_component;
+        case Parameter::V_FINAL_I_COMPONENT: return v_final_i_component;
+        case Parameter::V_FINAL_J_COMPONENT: return v_final_j_component;
+        case Parameter::Y_INITIAL: return y_initial;
+        case Parameter::ACC: return acc;
+        case Parameter::ANGLE: return angle;
+        case Parameter::TIME: return time;
+        case Parameter::RANGE: return range;
+        case Parameter::ABS_MAX_HEIGHT: return abs_max_height;
+        case Parameter::MAX_HEIGHT: return max_height;
+        case Parameter::TIME_OF_APEX: return apex_time;
+        case Parameter::INITIAL_SPEED: return v_initial;
+        case Parameter::FINAL_SPEED: return v_final;
+        default: return nullptr;
+    }
+}
+
+void ScenarioColumns::reset(std::size_t lane) const {
+    for (double *column : {y_initial, v_initial, v_final, acc, time, max_height, abs_max_height, range,
+                           v_initial_i_component, v_initial_j_component, v_final_i_component, v_final_j_component, apex_time})
+        column[lane] = 0.0;
+    angle[lane] = parameter_info(Parameter::ANGLE).default_value;
+}
+
+void ScenarioColumns::load(std::size_t lane, ParameterValues &parameters) const {
+    parameters[Parameter::Y_INITIAL] = y_initial[lane];
+    parameters[Parameter::INITIAL_SPEED] = v_initial[lane];
+    parameters[Parameter::FINAL_SPEED] = v_final[lane];
+    parameters[Parameter::ACC] = acc[lane];
+    parameters[Parameter::TIME] = time[lane];
+    parameters[Parameter::MAX_HEIGHT] = max_height[lane];
+    parameters[Parameter::ABS_MAX_HEIGHT] = abs_max_height[lane];
+    parameters[Parameter::RANGE] = range[lane];
+    parameters[Parameter::ANGLE] = angle[lane];
+    parameters[Parameter::V_INITIAL_I_COMPONENT] = v_initial_i_component[lane];
+    parameters[Parameter::V_INITIAL_J_COMPONENT] = v_initial_j_component[lane];
+    parameters[Parameter::V_FINAL_I_COMPONENT] = v_final_i_component[lane];
+    parameters[Parameter::V_FINAL_J_COMPONENT] = v_final_j_component[lane];
+    parameters[Parameter::TIME_OF_APEX] = apex_time[lane];
+}
+
+void ScenarioBatch::resize(std::size_t count){
+    for (std::vector<double> *column : {&y_initial, &v_initial, &v_final, &acc, &time, &max_height, &abs_max_height, &range,
+                                        &v_initial_i_component, &v_initial_j_component, &v_final_i_component, &v_final_j_component, &apex_time})
+        column->resize(count, 0.0);
+    angle.resize(count, 45.0); // Same default as the ANGLE parameter
+    status.resize(count, SolveStatus::SOLVED);
+}
+
+void ScenarioBatch::store(std::size_t lane, const ParameterValues &parameters){
+    y_initial[lane] = parameters[Parameter::Y_INITIAL];
+    v_initial[lane] = parameters[Parameter::INITIAL_SPEED];
+    v_final[lane] = parameters[Parameter::FINAL_SPEED];
+    acc[lane] = parameters[Parameter::ACC];
+    time[lane] = parameters[Parameter::TIME];
+    max_height[lane] = parameters[Parameter::MAX_HEIGHT];
+    abs_max_height[lane] = parameters[Parameter::ABS_MAX_HEIGHT];
+    range[lane] = parameters[Parameter::RANGE];
+    angle[lane] = parameters[Parameter::ANGLE];
+    v_initial_i_component[lane] = parameters[Parameter::V_INITIAL_I_COMPONENT];
+    v_initial_j_component[lane] = parameters[Parameter::V_INITIAL_J_COMPONENT];
+    v_final_i_component[lane] = parameters[Parameter::V_FINAL_I_COMPONENT];
+    v_final_j_component[lane] = parameters[Parameter::V_FINAL_J_COMPONENT];
+    apex_time[lane] = parameters[Parameter::TIME_OF_APEX];
+}
+
+ScenarioColumns ScenarioBatch::columns(){
+    return ScenarioColumns{size(), y_initial.data(), v_initial.data(), v_final.data(), acc.data(), time.data(), max_height.data(),
+                           abs_max_height.data(), range.data(), angle.data(), v_initial_i_component.data(), v_initial_j_component.data(),
+                           v_final_i_component.data(), v_final_j_component.data(), apex_time.data(), status.data()};
+}
+
+BatchKernel best_batch_kernel(){
+#if defined(KINEMATICS_HAVE_AVX2_KERNEL)
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2)
+        return BatchKernel::AVX2;
+#endif
+#if defined(__SSE2__)
+    return BatchKernel::SSE2;
+#else
+    return BatchKernel::SCALAR;
+#endif
+}
+
+const char *batch_kernel_name(BatchKernel kernel){
+    switch (kernel){
+        case BatchKernel::AVX2: return "avx2";
+        case BatchKernel::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+void find_unknown_batch(const ScenarioColumns &columns, BatchKernel kernel){
+    // Fall back to the widest kernel that exists when the requested one is not available
+    if (kernel == BatchKernel::AVX2 && best_batch_kernel() != BatchKernel::AVX2)
+        kernel = best_batch_kernel();
+
+    switch (kernel){
+#if defined(KINEMATICS_HAVE_AVX2_KERNEL)
+        case BatchKernel::AVX2:
+            find_unknown_batch_avx2(columns);
+            break;
+#endif
+#if defined(__SSE2__)
+        case BatchKernel::SSE2:
+            solve_columns<pack_sse2>(columns);
+            break;
+#endif
+        default:
+            solve_columns<pack_scalar>(columns);
+            break;
+    }
+
+    // Launches from a height, left alone by the kernels
+    const ScenarioColumns &c = columns;
+    for (std::size_t i = 0; i < c.count; i++){
+        if (c.y_initial[i] == 0.0)
+            continue;
+        const SolveStatus status = find_unknown(c.y_initial[i], c.v_initial[i], c.v_final[i], c.acc[i], c.time[i], c.max_height[i], c.abs_max_height[i],
+                                                c.range[i], c.angle[i], c.v_initial_i_component[i], c.v_initial_j_component[i],
+                                                c.v_final_i_component[i], c.v_final_j_component[i], c.apex_time[i]);
+        if (c.status != nullptr)
+            c.status[i] = status;
+    }
+}
+
+void find_unknown_batch(ScenarioBatch &batch, BatchKernel kernel){
+    find_unknown_batch(batch.columns(), kernel);
+}
+
+InputCheck solved_lane_check(const ScenarioColumns &columns, std::size_t lane){
+    if (columns.status[lane] == SolveStatus::NOT_CONVERGED)
+        return {InputError::NOT_CONVERGED};
+    if (columns.status[lane] == SolveStatus::UNSUPPORTED_KNOWN_SET)
+        return {InputError::UNSUPPORTED_KNOWN_SET};
+    if (columns.max_height[lane] < 0) // The input values lead to an impossible case
+        return {InputError::INCONSISTENT_VALUES};
+    return {};
+}
+
+void cleanup_input_batch(ParameterValues *tables, InputCheck *checks, std::size_t count, ScenarioBatch &scratch, BatchKernel kernel){
+    if (scratch.size() < count)
+        scratch.resize(count);
+
+    // Rejected tables still take a lane, the kernels cope with any values and their results are dropped
+    for (std::size_t i = 0; i < count; i++){
+        checks[i] = check_input(tables[i]);
+        scratch.store(i, tables[i]);
+    }
+    const ScenarioColumns columns = scratch.columns().slice(0, count);
+    find_unknown_batch(columns, kernel);
+
+    for (std::size_t i = 0; i < count; i++){
+        if (!checks[i].ok())
+            continue;
+        checks[i] = solved_lane_check(columns, i);
+        if (checks[i].ok() || checks[i].error == InputError::INCONSISTENT_VALUES)
+            columns.load(i, tables[i]);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// Structure-of-arrays batch version of find_unknown()
+//
+// Every lane is solved exactly like a call to find_unknown() with the same values: the lanes are grouped
+// by the case that applies to them and every group is solved with AVX2, SSE2 or scalar kernels. Launches from
+// a height have no cases, they are handed to the general solver (height_solver.hpp) one lane at a time afterwards.
+//
+// Accuracy: additions, multiplications, divisions and square roots are evaluated in the same order as in
+// find_unknown(), so the only difference comes from the launch angle:
+//  - angle inputs use the kernels' own sin/cos polynomials (within 1 ULP of libm), every output then stays
+//    within BATCH_ULP_TOLERANCE ULP of find_unknown()
+//  - vector inputs get sin/cos(atan(j / i)) as j / |v| and i / |v|, which is more accurate than the atan + cos
+//    round trip of find_unknown() for steep launches; the difference grows to BATCH_ULP_TOLERANCE + |j / i| ULP
+//  - results that cancel to (almost) zero, such as the max height over a full flight, can only be compared
+//    against the size of the cancelling terms
+#include "kinematics_core.hpp"
+#include <cstddef>
+#include <vector>
+
+const double BATCH_ULP_TOLERANCE {8};
+
+// Non-owning view over the columns of a batch, every column holds `count` values
+// The columns are inputs and outputs at the same time, like the references passed to find_unknown()
+struct ScenarioColumns{
+    std::size_t count {};
+    double *y_initial {}, *v_initial {}, *v_final {}, *acc {}, *time {}, *max_height {}, *abs_max_height {}, *range {};
+    double *angle {}; // Only written for launches from a height that solve the angle
+    double *v_initial_i_component {}, *v_initial_j_component {}, *v_final_i_component {}, *v_final_j_component {}, *apex_time {};
+    SolveStatus *status {}; // Optional, receives what find_unknown() would return for every lane
+
+    // View over the lanes [begin, begin + length)
+    ScenarioColumns slice(std::size_t begin, std::size_t length) const;
+
+    // Column holding a parameter, nullptr for the forces parameters
+    double *column(Parameter parameter) const;
+
+    // Puts a lane back to the default values, like ParameterValues::reset()
+    void reset(std::size_t lane) const;
+
+    // Copies a lane into the find_unknown() arguments of a parameter table, the forces parameters are left alone
+    void load(std::size_t lane, ParameterValues &parameters) const;
+};
+
+// Owning storage for a batch of scenarios
+struct ScenarioBatch{
+    std::vector<double> y_initial {}, v_initial {}, v_final {}, acc {}, time {}, max_height {}, abs_max_height {}, range {}, angle {};
+    std::vector<double> v_initial_i_component {}, v_initial_j_component {}, v_final_i_component {}, v_final_j_component {}, apex_time {};
+    std::vector<SolveStatus> status {};
+
+    void resize(std::size_t count);
+    std::size_t size() const { return y_initial.size(); }
+
+    // Copies the find_unknown() arguments of a parameter table into a lane, ScenarioColumns::load() copies it back
+    // The forces parameters have no column and are left alone
+    void store(std::size_t lane, const ParameterValues &parameters);
+    ScenarioColumns columns();
+};
+
+enum class BatchKernel {SCALAR, SSE2, AVX2};
+
+// Widest kernel supported by the compiler and the CPU running the program
+BatchKernel best_batch_kernel();
+const char *batch_kernel_name(BatchKernel kernel);
+
+// Solves every lane of the batch in place
+void find_unknown_batch(const ScenarioColumns &columns, BatchKernel kernel = best_batch_kernel());
+void find_unknown_batch(ScenarioBatch &batch, BatchKernel kernel = best_batch_kernel());
+
+// What cleanup_input() returns for a lane that passed check_input(), once find_unknown_batch() has solved it
+// The columns need a status column
+InputCheck solved_lane_check(const ScenarioColumns &columns, std::size_t lane);
+
+// Batch version of cleanup_input(): every table is checked on its own, then all of them are solved together
+// checks receives what cleanup_input() would return for every table; tables that fail their check are left as they were
+// scratch is resized as needed and can be reused between calls
+void cleanup_input_batch(ParameterValues *tables, InputCheck *checks, std::size_t count, ScenarioBatch &scratch,
+                         BatchKernel kernel = best_batch_kernel());
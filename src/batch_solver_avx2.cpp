@@ -0,0 +1,15 @@
+// AVX2 instantiation of the batch and targeting kernels, this file is the only one compiled with -mavx2
+#include "batch_kernels.hpp"
+#include "targeting_kernels.hpp"
+
+#if !defined(__AVX2__)
+#error "batch_solver_avx2.cpp has to be compiled with AVX2 enabled"
+#endif
+
+void find_unknown_batch_avx2(const ScenarioColumns &columns){
+    solve_columns<pack_avx2>(columns);
+}
+
+void solve_targets_avx2(const TargetingProblem &problem, const TargetColumns &columns){
+    solve_target_columns<pack_avx2>(problem, columns);
+}
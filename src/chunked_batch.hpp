@@ -0,0 +1,106 @@
+#pragma once
+
+// Static shapes binned into square world-space chunks, each chunk batched on its own
+// Only the chunks that overlap the view are drawn, so what a frame costs depends on what is on screen and not on
+// how far the scene reaches. A shape belongs to the chunk of its top-left corner and may reach into later chunks,
+// so each chunk keeps the bounds of its shapes and the lookup widens the view by the largest shape
+#include "shape_batch.hpp"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class chunked_batch{
+    private:
+        struct chunk{
+            sf::FloatRect bounds {};
+            bool empty {true};
+            shape_batch batch {};
+        };
+
+        const float chunk_size;
+        std::vector<chunk> chunks {}; // Kept across rebuilds so the GPU buffers are reused
+        std::unordered_map<std::uint64_t, std::size_t> chunk_index {};
+        sf::Vector2f largest {}; // Largest shape, how far a shape can reach past its own chunk
+
+        static std::uint64_t key(std::int64_t cx, std::int64_t cy){
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32 | static_cast<std::uint32_t>(cy);
+        }
+
+        std::int64_t cell(float coordinate) const { return static_cast<std::int64_t>(std::floor(coordinate / chunk_size)); }
+
+        static bool overlaps(const sf::FloatRect &a, const sf::FloatRect &b){
+            return a.position.x <= b.position.x + b.size.x && b.position.x <= a.position.x + a.size.x &&
+                   a.position.y <= b.position.y + b.size.y && b.position.y <= a.position.y + a.size.y;
+        }
+
+    public:
+        explicit chunked_batch(float chunk_size = 1024.f): chunk_size(chunk_size) {}
+
+        // Drops every shape but keeps the chunks and their memory for the next rebuild
+        void clear(){
+            for (chunk &c : chunks){
+                c.batch.clear();
+                c.empty = true;
+            }
+            largest = {};
+        }
+
+        void add(const sf::Shape &shape){
+            const sf::FloatRect bounds = shape.getGlobalBounds();
+            const auto [slot, inserted] = chunk_index.try_emplace(key(cell(bounds.position.x), cell(bounds.position.y)), chunks.size());
+            if (inserted)
+                chunks.emplace_back();
+
+            chunk &c = chunks[slot->second];
+            if (c.empty)
+                c.bounds = bounds;
+            else{
+                const float left = std::min(c.bounds.position.x, bounds.position.x), top = std::min(c.bounds.position.y, bounds.position.y);
+                const float right = std::max(c.bounds.position.x + c.bounds.size.x, bounds.position.x + bounds.size.x);
+                const float bottom = std::max(c.bounds.position.y + c.bounds.size.y, bounds.position.y + bounds.size.y);
+                c.bounds = {{left, top}, {right - left, bottom - top}};
+            }
+            c.empty = false;
+            c.batch.add(shape);
+            largest = {std::max(largest.x, bounds.size.x), std::max(largest.y, bounds.size.y)};
+        }
+
+        // Sends the vertices to the GPU, call once after a rebuild
+        void upload(){
+            for (chunk &c : chunks)
+                c.batch.upload();
+        }
+
+        // Draws the chunks that overlap view, returns the number of draw calls issued and counts the chunks drawn
+        unsigned int draw(sf::RenderTarget &target, const sf::FloatRect &view, std::size_t &chunks_drawn) const {
+            unsigned int draw_calls {};
+            auto draw_chunk = [&](const chunk &c){
+                if (c.empty || !overlaps(c.bounds, view))
+                    return;
+                draw_calls += c.batch.draw(target);
+                chunks_drawn++;
+            };
+
+            const std::int64_t first_x = cell(view.position.x - largest.x), last_x = cell(view.position.x + view.size.x);
+            const std::int64_t first_y = cell(view.position.y - largest.y), last_y = cell(view.position.y + view.size.y);
+            // Zoomed far out the view covers more cells than there are chunks, then every chunk is tested instead
+            if (static_cast<double>(last_x - first_x + 1) * static_cast<double>(last_y - first_y + 1) > static_cast<double>(chunks.size())){
+                for (const chunk &c : chunks)
+                    draw_chunk(c);
+                return draw_calls;
+            }
+
+            for (std::int64_t cx = first_x; cx <= last_x; cx++){
+                for (std::int64_t cy = first_y; cy <= last_y; cy++){
+                    const auto found = chunk_index.find(key(cx, cy));
+                    if (found != chunk_index.end())
+                        draw_chunk(chunks[found->second]);
+                }
+            }
+            return draw_calls;
+        }
+};
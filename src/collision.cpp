@@ -0,0 +1,184 @@
+#include "collision.hpp"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+const std::size_t MIN_TABLE_SIZE {64};
+const std::size_t MAX_QUERY_PIECES {4096}; // Longer paths get pieces longer than a cell, they only cover more cells
+
+// Times t >= 0 where p + v t + a t^2 / 2 = target, in increasing order; returns how many there are
+int crossings(double p, double v, double a, double target, double (&roots)[2]){
+    const double c = p - target;
+    if (a == 0){
+        if (v == 0)
+            return 0;
+        roots[0] = -c / v;
+        return roots[0] >= 0 ? 1 : 0;
+    }
+
+    const double half = 0.5 * a, discriminant = v * v - 4 * half * c;
+    if (discriminant < 0)
+        return 0;
+    // Roots from the larger one and the product, neither cancels
+    const double q = -0.5 * (v + std::copysign(std::sqrt(discriminant), v));
+    double first = q / half, second = q != 0 ? c / q : first;
+    if (first > second)
+        std::swap(first, second);
+
+    int count {};
+    for (double root : {first, second}){
+        if (root >= 0)
+            roots[count++] = root;
+    }
+    return count;
+}
+
+// First time in [0, duration] the path moves into the box through one of its edges
+bool enter_time(const Parabola &path, const Obstacle &box, double duration, double &time, ObstacleFace &face){
+    bool found {false};
+    auto consider = [&](double t, ObstacleFace crossed){
+        if (t <= duration && (!found || t < time)){
+            time = t;
+            face = crossed;
+            found = true;
+        }
+    };
+
+    double roots[2] {};
+    // Vertical edges: x reaches the edge while moving into the box and y is within it
+    for (const auto &[edge, crossed, inward] : {std::tuple{box.left, ObstacleFace::LEFT, 1.0}, std::tuple{box.right, ObstacleFace::RIGHT, -1.0}}){
+        const int count = crossings(path.x, path.vx, path.ax, edge, roots);
+        for (int i = 0; i < count; i++){
+            const double t = roots[i], y = path.y_at(t);
+            if ((path.vx + path.ax * t) * inward > 0 && y >= box.bottom && y <= box.top)
+                consider(t, crossed);
+        }
+    }
+    // Horizontal edges
+    for (const auto &[edge, crossed, inward] : {std::tuple{box.bottom, ObstacleFace::BOTTOM, 1.0}, std::tuple{box.top, ObstacleFace::TOP, -1.0}}){
+        const int count = crossings(path.y, path.vy, path.ay, edge, roots);
+        for (int i = 0; i < count; i++){
+            const double t = roots[i], x = path.x_at(t);
+            if ((path.vy + path.ay * t) * inward > 0 && x >= box.left && x <= box.right)
+                consider(t, crossed);
+        }
+    }
+    return found;
+}
+
+// Range of p + v t + a t^2 / 2 over [from, to]
+void extent(double p, double v, double a, double from, double to, double &low, double &high){
+    auto at = [&](double t){ return p + t * (v + 0.5 * t * a); };
+    low = std::min(at(from), at(to));
+    high = std::max(at(from), at(to));
+    if (a != 0){
+        const double turn = -v / a;
+        if (turn > from && turn < to){
+            low = std::min(low, at(turn));
+            high = std::max(high, at(turn));
+        }
+    }
+}
+
+std::size_t obstacle_grid::bucket_of(std::int64_t cell_x, std::int64_t cell_y) const{
+    std::uint64_t h = static_cast<std::uint64_t>(cell_x) * 0x9E3779B97F4A7C15ULL ^ static_cast<std::uint64_t>(cell_y) * 0xC2B2AE3D27D4EB4FULL;
+    h ^= h >> 32;
+    return static_cast<std::size_t>(h) & table_mask;
+}
+
+void obstacle_grid::build(std::vector<Obstacle> new_obstacles, double new_cell_size){
+    obstacles = std::move(new_obstacles);
+
+    cell_size = new_cell_size;
+    if (cell_size <= 0){
+        double total {};
+        for (const Obstacle &o : obstacles)
+            total += std::max(o.right - o.left, o.top - o.bottom);
+        cell_size = obstacles.empty() || total <= 0 ? 1 : 2 * total / obstacles.size();
+    }
+
+    auto cells_of = [&](const Obstacle &o, std::int64_t (&range)[4]){
+        range[0] = static_cast<std::int64_t>(std::floor(o.left / cell_size));
+        range[1] = static_cast<std::int64_t>(std::floor(o.right / cell_size));
+        range[2] = static_cast<std::int64_t>(std::floor(o.bottom / cell_size));
+        range[3] = static_cast<std::int64_t>(std::floor(o.top / cell_size));
+    };
+
+    std::size_t entries {};
+    std::int64_t range[4] {};
+    for (const Obstacle &o : obstacles){
+        cells_of(o, range);
+        entries += static_cast<std::size_t>((range[1] - range[0] + 1) * (range[3] - range[2] + 1));
+    }
+    std::size_t table_size {MIN_TABLE_SIZE};
+    while (table_size < 2 * entries)
+        table_size *= 2;
+    table_mask = table_size - 1;
+
+    // Count, then fill: bucket_start ends up as the offsets of the flat lists
+    bucket_start.assign(table_size + 1, 0);
+    for (const Obstacle &o : obstacles){
+        cells_of(o, range);
+        for (std::int64_t cx = range[0]; cx <= range[1]; cx++)
+            for (std::int64_t cy = range[2]; cy <= range[3]; cy++)
+                bucket_start[bucket_of(cx, cy) + 1]++;
+    }
+    for (std::size_t b = 0; b < table_size; b++)
+        bucket_start[b + 1] += bucket_start[b];
+
+    bucket_items.resize(entries);
+    std::vector<std::uint32_t> cursor(bucket_start.begin(), bucket_start.end() - 1);
+    for (std::size_t i = 0; i < obstacles.size(); i++){
+        cells_of(obstacles[i], range);
+        for (std::int64_t cx = range[0]; cx <= range[1]; cx++)
+            for (std::int64_t cy = range[2]; cy <= range[3]; cy++)
+                bucket_items[cursor[bucket_of(cx, cy)]++] = static_cast<std::uint32_t>(i);
+    }
+}
+
+ObstacleHit obstacle_grid::first_hit(const Parabola &path, double duration) const{
+    ObstacleHit best {};
+    if (obstacles.empty() || !(duration > 0))
+        return best;
+
+    // The speed along a parabola is largest at one of the ends, so this bounds the length of the path
+    const double end_vx = path.vx + path.ax * duration, end_vy = path.vy + path.ay * duration;
+    const double length = std::max(std::hypot(path.vx, path.vy), std::hypot(end_vx, end_vy)) * duration;
+    const std::size_t pieces = std::clamp<std::size_t>(static_cast<std::size_t>(std::ceil(length / cell_size)), 1, MAX_QUERY_PIECES);
+
+    thread_local std::vector<std::uint32_t> tested {}; // Sorted, every obstacle is tested once per query
+    tested.clear();
+
+    for (std::size_t piece = 0; piece < pieces; piece++){
+        const double from = duration * piece / pieces, to = duration * (piece + 1) / pieces;
+        double low_x {}, high_x {}, low_y {}, high_y {};
+        extent(path.x, path.vx, path.ax, from, to, low_x, high_x);
+        extent(path.y, path.vy, path.ay, from, to, low_y, high_y);
+
+        const std::int64_t first_x = static_cast<std::int64_t>(std::floor(low_x / cell_size)), last_x = static_cast<std::int64_t>(std::floor(high_x / cell_size));
+        const std::int64_t first_y = static_cast<std::int64_t>(std::floor(low_y / cell_size)), last_y = static_cast<std::int64_t>(std::floor(high_y / cell_size));
+        for (std::int64_t cx = first_x; cx <= last_x; cx++){
+            for (std::int64_t cy = first_y; cy <= last_y; cy++){
+                const std::size_t bucket = bucket_of(cx, cy);
+                for (std::uint32_t k = bucket_start[bucket]; k < bucket_start[bucket + 1]; k++){
+                    const std::uint32_t item = bucket_items[k];
+                    const auto slot = std::lower_bound(tested.begin(), tested.end(), item);
+                    if (slot != tested.end() && *slot == item)
+                        continue;
+                    tested.insert(slot, item);
+
+                    double time {};
+                    ObstacleFace face {};
+                    if (enter_time(path, obstacles[item], duration, time, face) && (!best.hit || time < best.time))
+                        best = {true, time, item, face};
+                }
+            }
+        }
+
+        // Obstacles first met in later pieces can only be entered after this piece ends
+        if (best.hit && best.time <= to)
+            break;
+    }
+    return best;
+}
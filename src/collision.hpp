@@ -0,0 +1,57 @@
+#pragma once
+
+// Collisions of free-flying projectiles with rectangular obstacles
+// Broad phase: a uniform grid hashed into a fixed table; every obstacle is listed in each cell it covers, and the
+// buckets are stored flat (one offset array, one index array) so a lookup touches two arrays
+// Narrow phase: the flight is a parabola, so the time it enters a box through one of its edges is a root of a
+// quadratic; only crossings that move into the box count, and the earliest one is the hit
+//
+// A query walks the parabola in pieces no longer than a cell and only tests obstacles listed in the cells the
+// pieces cover, in time order, stopping as soon as a hit comes before the next piece. The cost depends on the
+// cells the path crosses and the obstacles near it, not on how many obstacles the scene holds
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Obstacle{
+    double left {}, bottom {}, right {}, top {}; // y up
+};
+
+// p(t) = p + v t + a t^2 / 2
+struct Parabola{
+    double x {}, y {}, vx {}, vy {}, ax {}, ay {};
+
+    double x_at(double t) const { return x + t * (vx + 0.5 * t * ax); }
+    double y_at(double t) const { return y + t * (vy + 0.5 * t * ay); }
+};
+
+enum class ObstacleFace {LEFT, RIGHT, BOTTOM, TOP};
+
+struct ObstacleHit{
+    bool hit {false};
+    double time {};
+    std::size_t obstacle {}; // Index in the list the grid was built from
+    ObstacleFace face {};
+};
+
+class obstacle_grid{
+    private:
+        std::vector<Obstacle> obstacles {};
+        double cell_size {1};
+        std::size_t table_mask {};
+        std::vector<std::uint32_t> bucket_start {}, bucket_items {}; // Bucket b lists bucket_items[bucket_start[b], bucket_start[b + 1])
+
+        std::size_t bucket_of(std::int64_t cell_x, std::int64_t cell_y) const;
+
+    public:
+        // Hashes the obstacles; a cell size of 0 picks twice the average obstacle size
+        void build(std::vector<Obstacle> new_obstacles, double new_cell_size = 0);
+
+        // First time in [0, duration] the parabola enters an obstacle, a path that starts inside one ignores it
+        // until it has left; thread safe, the grid is only read
+        ObstacleHit first_hit(const Parabola &path, double duration) const;
+
+        std::size_t size() const { return obstacles.size(); }
+        const Obstacle &operator[](std::size_t i) const { return obstacles[i]; }
+        double cell() const { return cell_size; }
+};
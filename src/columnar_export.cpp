@@ -0,0 +1,304 @@
+#include "columnar_export.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define KINEMATICS_EXPORT_MMAP
+#endif
+
+const char EXPORT_MAGIC[8] {'K', 'I', 'N', 'C', 'O', 'L', '0', '1'};
+const std::size_t ROW_COUNT_OFFSET {16}; // Position of row_count in the header
+
+#if defined(KINEMATICS_EXPORT_MMAP)
+// Appends through a memory-mapped window that slides over the file, the file grows one window at a time
+// Only the current window is mapped, finished windows are left to the kernel to write back
+// Every window is allocated on disk before it is mapped: writing into a hole of a sparse file fails with SIGBUS
+// once the disk is full, an allocation that fails is reported like any other error
+class sequential_file{
+    private:
+        static constexpr std::size_t WINDOW_BYTES {std::size_t{64} << 20};
+
+        int fd {-1};
+        char *window {};
+        std::size_t window_start {}, window_used {}; // window_start is always a multiple of WINDOW_BYTES
+        std::string &error;
+
+        bool fail(const char *what, int code = errno){
+            error = std::string{what} + ": " + std::strerror(code);
+            return false;
+        }
+
+        bool unmap(){
+            if (window != nullptr && munmap(window, WINDOW_BYTES) != 0)
+                return fail("Could not unmap export window");
+            window = nullptr;
+            return true;
+        }
+
+        bool map_next(){
+            if (!unmap())
+                return false;
+            int result {};
+            do
+                result = posix_fallocate(fd, static_cast<off_t>(window_start), static_cast<off_t>(WINDOW_BYTES));
+            while (result == EINTR);
+            if (result != 0)
+                return fail("Could not grow export file", result); // posix_fallocate returns the error instead of setting errno
+
+            void *mapped = mmap(nullptr, WINDOW_BYTES, PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(window_start));
+            if (mapped == MAP_FAILED)
+                return fail("Could not map export file");
+            window = static_cast<char *>(mapped);
+            madvise(window, WINDOW_BYTES, MADV_SEQUENTIAL);
+            window_used = 0;
+            return true;
+        }
+
+    public:
+        explicit sequential_file(std::string &error): error(error) {}
+        ~sequential_file(){
+            unmap();
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        bool open(const std::string &path){
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+                return fail(("Could not create " + path).c_str());
+            return map_next();
+        }
+
+        bool write(const void *data, std::size_t size){
+            const char *bytes = static_cast<const char *>(data);
+            while (size > 0){
+                if (window_used == WINDOW_BYTES){
+                    window_start += WINDOW_BYTES;
+                    if (!map_next())
+                        return false;
+                }
+                const std::size_t length = std::min(size, WINDOW_BYTES - window_used);
+                std::memcpy(window + window_used, bytes, length);
+                window_used += length;
+                bytes += length;
+                size -= length;
+            }
+            return true;
+        }
+
+        // Overwrites bytes that were already written, used to finish the header
+        bool patch(std::size_t offset, const void *data, std::size_t size){
+            if (offset >= window_start){
+                std::memcpy(window + (offset - window_start), data, size);
+                return true;
+            }
+            if (pwrite(fd, data, size, static_cast<off_t>(offset)) != static_cast<ssize_t>(size))
+                return fail("Could not finish export header");
+            return true;
+        }
+
+        // Cuts off the unused end of the last window
+        bool close(){
+            const std::size_t size = window_start + window_used;
+            if (!unmap())
+                return false;
+            if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+                return fail("Could not truncate export file");
+            const int result = ::close(fd);
+            fd = -1;
+            return result == 0 ? true : fail("Could not close export file");
+        }
+};
+#else
+// Portable fallback, plain buffered writes
+class sequential_file{
+    private:
+        std::FILE *file {};
+        std::string &error;
+
+    public:
+        explicit sequential_file(std::string &error): error(error) {}
+        ~sequential_file(){
+            if (file != nullptr)
+                std::fclose(file);
+        }
+
+        bool open(const std::string &path){
+            file = std::fopen(path.c_str(), "wb");
+            if (file == nullptr)
+                error = "Could not create " + path;
+            return file != nullptr;
+        }
+
+        bool write(const void *data, std::size_t size){
+            if (std::fwrite(data, 1, size, file) == size)
+                return true;
+            error = "Could not write export file";
+            return false;
+        }
+
+        bool patch(std::size_t offset, const void *data, std::size_t size){
+            const long end = std::ftell(file);
+            const bool written = std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0 && std::fwrite(data, 1, size, file) == size &&
+                                 std::fseek(file, end, SEEK_SET) == 0;
+            if (!written)
+                error = "Could not finish export header";
+            return written;
+        }
+
+        bool close(){
+            const bool closed = std::fclose(file) == 0;
+            file = nullptr;
+            if (!closed)
+                error = "Could not close export file";
+            return closed;
+        }
+};
+#endif
+
+// Fixed size, zero padded name field
+void copy_name(char (&field)[EXPORT_NAME_LENGTH], const std::string &name){
+    std::memset(field, 0, EXPORT_NAME_LENGTH);
+    std::memcpy(field, name.data(), std::min(name.size(), EXPORT_NAME_LENGTH - 1));
+}
+
+table_writer::table_writer() = default;
+table_writer::~table_writer() = default;
+
+bool table_writer::open(const std::string &path, ExportFormat new_format, const std::vector<std::string> &columns, const ParameterValues *parameters){
+    format = new_format;
+    column_count = columns.size();
+    block.assign(column_count * EXPORT_BLOCK_ROWS, 0.0);
+    block_rows = 0;
+    row_count = 0;
+    file = std::make_unique<sequential_file>(error);
+    if (!file->open(path))
+        return false;
+
+    if (format == ExportFormat::CSV){
+        // Scenario values go into comment lines so the file stays a plain table
+        std::string header {};
+        if (parameters != nullptr){
+            char line[96];
+            for (const ParameterInfo &info : PARAMETER_INFO){
+                std::snprintf(line, sizeof(line), "# %s=%.17g\n", info.name, (*parameters)[info.parameter]);
+                header += line;
+            }
+        }
+        for (std::size_t c = 0; c < column_count; c++)
+            header += columns[c] + (c + 1 < column_count ? "," : "\n");
+        return file->write(header.data(), header.size());
+    }
+
+    const std::uint32_t counts[2] {static_cast<std::uint32_t>(column_count), parameters != nullptr ? static_cast<std::uint32_t>(PARAMETER_COUNT) : 0u};
+    const std::uint64_t rows_placeholder {0};
+    bool written = file->write(EXPORT_MAGIC, sizeof(EXPORT_MAGIC)) && file->write(counts, sizeof(counts)) &&
+                   file->write(&rows_placeholder, sizeof(rows_placeholder));
+
+    char name[EXPORT_NAME_LENGTH];
+    for (const std::string &column : columns){
+        copy_name(name, column);
+        written = written && file->write(name, sizeof(name));
+    }
+    if (parameters != nullptr){
+        for (const ParameterInfo &info : PARAMETER_INFO){
+            copy_name(name, info.name);
+            const double value = (*parameters)[info.parameter];
+            written = written && file->write(name, sizeof(name)) && file->write(&value, sizeof(value));
+        }
+    }
+    return written;
+}
+
+bool table_writer::flush_block(){
+    if (block_rows == 0)
+        return true;
+
+    bool written {true};
+    if (format == ExportFormat::CSV){
+        // Rows are formatted into one buffer per block, one write per block
+        std::string text {};
+        text.reserve(block_rows * column_count * 24);
+        char number[32];
+        for (std::size_t r = 0; r < block_rows; r++){
+            for (std::size_t c = 0; c < column_count; c++){
+                const int length = std::snprintf(number, sizeof(number), "%.17g", block[c * EXPORT_BLOCK_ROWS + r]);
+                text.append(number, static_cast<std::size_t>(length));
+                text += c + 1 < column_count ? ',' : '\n';
+            }
+        }
+        written = file->write(text.data(), text.size());
+    }
+    else{
+        const std::uint64_t rows {block_rows};
+        written = file->write(&rows, sizeof(rows));
+        for (std::size_t c = 0; c < column_count && written; c++)
+            written = file->write(block.data() + c * EXPORT_BLOCK_ROWS, block_rows * sizeof(double));
+    }
+    block_rows = 0;
+    return written;
+}
+
+bool table_writer::write_row(const double *values){
+    for (std::size_t c = 0; c < column_count; c++)
+        block[c * EXPORT_BLOCK_ROWS + block_rows] = values[c];
+    block_rows++;
+    row_count++;
+    return block_rows < EXPORT_BLOCK_ROWS || flush_block();
+}
+
+bool table_writer::close(){
+    if (file == nullptr)
+        return false;
+
+    bool written = flush_block();
+    if (written && format == ExportFormat::BINARY)
+        written = file->patch(ROW_COUNT_OFFSET, &row_count, sizeof(row_count));
+    written = file->close() && written;
+    file.reset();
+    return written;
+}
+
+// Writes time, x, y, vx, vy at count times, time_of(i) gives the i-th
+template <typename TimeOf>
+bool write_trajectory(const std::string &path, ExportFormat format, const Trajectory &trajectory, const ParameterValues &parameters,
+                      std::size_t count, TimeOf time_of, std::string &error){
+    table_writer writer {};
+    if (!writer.open(path, format, {"time", "x", "y", "vx", "vy"}, &parameters)){
+        error = writer.last_error();
+        return false;
+    }
+
+    for (std::size_t i = 0; i < count; i++){
+        const double time = time_of(i);
+        const double row[5] {time, trajectory.x_at(time), trajectory.y_at(time), trajectory.vx_at(time), trajectory.vy_at(time)};
+        if (!writer.write_row(row)){
+            error = writer.last_error();
+            return false;
+        }
+    }
+
+    if (!writer.close()){
+        error = writer.last_error();
+        return false;
+    }
+    return true;
+}
+
+bool export_trajectory(const std::string &path, ExportFormat format, const Trajectory &trajectory, const ParameterValues &parameters,
+                       std::size_t sample_count, std::string &error){
+    const std::size_t count = trajectory.end_time > 0 ? std::max<std::size_t>(sample_count, 2) : 0;
+    const double time_step = count > 1 ? trajectory.end_time / (count - 1) : 0;
+    return write_trajectory(path, format, trajectory, parameters, count,
+                            [&](std::size_t i){ return i == count - 1 ? trajectory.end_time : i * time_step; }, error);
+}
+
+bool export_trajectory(const std::string &path, ExportFormat format, const Trajectory &trajectory, const ParameterValues &parameters,
+                       const std::vector<double> &times, std::string &error){
+    return write_trajectory(path, format, trajectory, parameters, times.size(), [&](std::size_t i){ return times[i]; }, error);
+}
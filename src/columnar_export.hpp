@@ -0,0 +1,67 @@
+#pragma once
+
+// Streaming export of trajectories and batch results, as a columnar binary file or as CSV
+//
+// Binary layout (little endian), written front to back so any number of rows fits in bounded memory:
+//   header   char[8] "KINCOL01", uint32 column_count, uint32 parameter_count, uint64 row_count
+//            column_count x char[32] column name
+//            parameter_count x {char[32] parameter name, double value}
+//   blocks   uint64 rows, then each column as `rows` doubles, repeated until row_count rows are stored
+// Values are stored in host byte order, every platform the simulator builds for is little endian
+// On Linux and other Unix systems the file is written through a sliding memory-mapped window, elsewhere with stdio
+#include "kinematics_core.hpp"
+#include "trajectory.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class ExportFormat {BINARY, CSV};
+
+const std::size_t EXPORT_NAME_LENGTH {32};
+const std::size_t EXPORT_BLOCK_ROWS {65536};
+
+// Output file that only ever grows at the end, see columnar_export.cpp
+class sequential_file;
+
+// Writes rows of doubles, buffering one block of rows at a time
+class table_writer{
+    private:
+        ExportFormat format {ExportFormat::BINARY};
+        std::size_t column_count {};
+        std::vector<double> block {}; // Column-major, EXPORT_BLOCK_ROWS rows per column
+        std::size_t block_rows {};
+        std::uint64_t row_count {};
+        std::string error {};
+        std::unique_ptr<sequential_file> file {}; // Reports into error, so it is declared after it
+
+        bool flush_block();
+
+    public:
+        table_writer();
+        ~table_writer();
+        table_writer(const table_writer &) = delete;
+        table_writer &operator=(const table_writer &) = delete;
+
+        // Creates the file and writes the header, parameters may be nullptr when the table has no scenario
+        bool open(const std::string &path, ExportFormat format, const std::vector<std::string> &columns, const ParameterValues *parameters);
+
+        // values holds one value per column
+        bool write_row(const double *values);
+
+        // Flushes the last block and finishes the header; the file is incomplete unless this returns true
+        bool close();
+
+        std::uint64_t rows() const { return row_count; }
+        const std::string &last_error() const { return error; }
+};
+
+// Exports time, x, y, vx, vy of sample_count evenly spaced samples from launch to landing, x from the launch point and
+// y from the ground; the last row is at the landing time, so it holds the solved TIME and RANGE
+bool export_trajectory(const std::string &path, ExportFormat format, const Trajectory &trajectory, const ParameterValues &parameters,
+                       std::size_t sample_count, std::string &error);
+
+// Exports the same columns at the given times, such as those of sample_polyline()
+bool export_trajectory(const std::string &path, ExportFormat format, const Trajectory &trajectory, const ParameterValues &parameters,
+                       const std::vector<double> &times, std::string &error);
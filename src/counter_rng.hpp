@@ -0,0 +1,60 @@
+#pragma once
+
+// Counter-based random numbers: Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+// The numbers are a pure function of (key, counter), so any thread can produce the numbers of any sample
+// without sharing state, and the results do not depend on how the samples were split between threads
+#include <cmath>
+#include <cstdint>
+
+struct philox_block{
+    std::uint32_t word[4];
+};
+
+inline philox_block philox4x32(philox_block counter, std::uint64_t key){
+    constexpr std::uint32_t MULTIPLIER_0 {0xD2511F53u}, MULTIPLIER_1 {0xCD9E8D57u};
+    constexpr std::uint32_t WEYL_0 {0x9E3779B9u}, WEYL_1 {0xBB67AE85u};
+
+    std::uint32_t key_0 = static_cast<std::uint32_t>(key), key_1 = static_cast<std::uint32_t>(key >> 32);
+    for (int round = 0; round < 10; round++){
+        const std::uint64_t product_0 = std::uint64_t{MULTIPLIER_0} * counter.word[0];
+        const std::uint64_t product_1 = std::uint64_t{MULTIPLIER_1} * counter.word[2];
+        counter = {{static_cast<std::uint32_t>(product_1 >> 32) ^ counter.word[1] ^ key_0, static_cast<std::uint32_t>(product_1),
+                    static_cast<std::uint32_t>(product_0 >> 32) ^ counter.word[3] ^ key_1, static_cast<std::uint32_t>(product_0)}};
+        key_0 += WEYL_0;
+        key_1 += WEYL_1;
+    }
+    return counter;
+}
+
+// Uniform double in (0, 1) from 64 random bits, never exactly 0 so it is safe to take the log of
+inline double unit_double(std::uint32_t high, std::uint32_t low){
+    const std::uint64_t bits = (std::uint64_t{high} << 32 | low) >> 11; // 53 bits
+    return (static_cast<double>(bits) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Stream of numbers for one (key, stream, index); every call draws from a fresh counter block
+struct counter_rng{
+    std::uint64_t key;
+    std::uint64_t index;
+    std::uint32_t stream;
+
+    // Two independent uniforms in (0, 1)
+    void uniform_pair(double &first, double &second) const {
+        const philox_block block = philox4x32({{static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32), stream, 0}}, key);
+        first = unit_double(block.word[0], block.word[1]);
+        second = unit_double(block.word[2], block.word[3]);
+    }
+
+    // Standard normal deviate (Box-Muller)
+    double normal() const {
+        double first {}, second {};
+        uniform_pair(first, second);
+        return std::sqrt(-2 * std::log(first)) * std::cos(2 * M_PI * second);
+    }
+
+    double uniform() const {
+        double first {}, second {};
+        uniform_pair(first, second);
+        return first;
+    }
+};
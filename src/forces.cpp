@@ -0,0 +1,408 @@
+#include "forces.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+// Dormand-Prince 5(4) tableau, the 7th stage is the derivative at the new state and becomes the next first stage
+const std::size_t STAGES {7};
+inline constexpr double DOPRI_A[STAGES][STAGES - 1] {
+    {},
+    {1.0 / 5},
+    {3.0 / 40, 9.0 / 40},
+    {44.0 / 45, -56.0 / 15, 32.0 / 9},
+    {19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729},
+    {9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656},
+    {35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84}
+};
+// Difference between the 5th and the 4th order solution
+inline constexpr double DOPRI_E[STAGES] {71.0 / 57600, 0, -71.0 / 16695, 71.0 / 1920, -17253.0 / 339200, 22.0 / 525, -1.0 / 40};
+// Dense output (Hairer, Norsett and Wanner), 5th coefficient of the interpolant
+inline constexpr double DOPRI_D[STAGES] {-12715105075.0 / 11282082432, 0, 87487479700.0 / 32700410799, -10690763975.0 / 1880347072,
+                                         701980252875.0 / 199316789632, -1453857185.0 / 822651844, 69997945.0 / 29380423};
+
+const double STEP_SAFETY {0.9}, MIN_STEP_SCALE {0.2}, MAX_STEP_SCALE {5};
+const int EVENT_BISECTIONS {60};
+const std::size_t TILE_SLOTS {128}; // Slots stepped together, their stages stay in L1/L2
+
+const std::size_t X {0}, Y {1}, VX {2}, VY {3}, N {ForceTrajectory::COMPONENTS};
+
+void ForceTrajectory::add_step(double t0, double h, const double (&step_coefficients)[COEFFICIENTS][COMPONENTS]){
+    segment &added = segments.emplace_back();
+    added.start = t0;
+    added.step = h;
+    std::copy(&step_coefficients[0][0], &step_coefficients[0][0] + COEFFICIENTS * COMPONENTS, &added.coefficients[0][0]);
+}
+
+void ForceTrajectory::add_rest(double t0, const ForceState &state){
+    const double rest[COEFFICIENTS][COMPONENTS] {{state.x, state.y, state.vx, state.vy}};
+    add_step(t0, 0, rest);
+}
+
+ForceState ForceTrajectory::state_at(double t) const{
+    if (segments.empty())
+        return {};
+    t = std::clamp(t, 0.0, end);
+
+    const auto after = std::upper_bound(segments.begin() + 1, segments.end(), t, [](double time, const segment &s){ return time < s.start; });
+    const segment &s = *(after - 1);
+    const double theta = s.step > 0 ? (t - s.start) / s.step : 0, rest = 1 - theta;
+    const auto &r = s.coefficients;
+    double value[COMPONENTS] {};
+    for (std::size_t c = 0; c < COMPONENTS; c++)
+        value[c] = r[0][c] + theta * (r[1][c] + rest * (r[2][c] + theta * (r[3][c] + rest * r[4][c])));
+    return {value[X], value[Y], value[VX], value[VY]};
+}
+
+// Working columns of the bodies that are still moving, slot i holds body[i]
+// Forces are kept divided by the mass, friction as the deceleration it causes in the current direction
+struct body_columns{
+    std::vector<std::size_t> body {};
+    std::vector<double> t {}, h {}, end {};
+    std::vector<double> state[N] {}, first[N] {}; // first: derivative at state, the first stage of the next step
+    std::vector<double> push {}, friction {}, slide {}, linear {}, quadratic {}, gravity {};
+    std::vector<double> moving {}, airborne {};  // 1 or 0, multiply the horizontal and vertical accelerations
+    std::vector<double> direction {};            // Sign of vx friction acts against, 0 while friction is off
+    std::vector<std::uint8_t> rejected {};       // Last attempt was rejected, the next step may not grow
+    std::vector<std::uint8_t> alive {};          // Cleared once the body is done, the slot is dropped after the round
+
+    void resize(std::size_t count){
+        body.resize(count);
+        for (std::vector<double> *column : {&t, &h, &end, &push, &friction, &slide, &linear, &quadratic, &gravity, &moving, &airborne, &direction})
+            column->resize(count);
+        for (std::size_t c = 0; c < N; c++){
+            state[c].resize(count);
+            first[c].resize(count);
+        }
+        rejected.resize(count);
+        alive.resize(count);
+    }
+
+    void move_slot(std::size_t from, std::size_t to){
+        body[to] = body[from];
+        for (std::vector<double> *column : {&t, &h, &end, &push, &friction, &slide, &linear, &quadratic, &gravity, &moving, &airborne, &direction})
+            (*column)[to] = (*column)[from];
+        for (std::size_t c = 0; c < N; c++){
+            state[c][to] = state[c][from];
+            first[c][to] = first[c][from];
+        }
+        rejected[to] = rejected[from];
+        alive[to] = alive[from];
+    }
+
+    // Derivative of slot i at z, without branches so every slot runs the same code
+    void derivative(std::size_t i, const double (&z)[N], double (&dz)[N]) const{
+        const double drag = linear[i] + quadratic[i] * std::sqrt(z[VX] * z[VX] + z[VY] * z[VY]);
+        dz[X] = z[VX];
+        dz[Y] = z[VY];
+        dz[VX] = moving[i] * (push[i] - slide[i] - drag * z[VX]);
+        dz[VY] = airborne[i] * (gravity[i] - drag * z[VY]);
+    }
+
+    void refresh_first(std::size_t i){
+        double z[N], dz[N];
+        for (std::size_t c = 0; c < N; c++)
+            z[c] = state[c][i];
+        derivative(i, z, dz);
+        for (std::size_t c = 0; c < N; c++)
+            first[c][i] = dz[c];
+    }
+
+    // Picks what friction does to a block with vx: it acts against the motion, and a block at rest only starts
+    // sliding when the push beats static friction; returns false when the block stays at rest
+    bool set_friction(std::size_t i, double vx){
+        double heading = vx > 0 ? 1 : (vx < 0 ? -1 : 0);
+        if (heading == 0 && std::fabs(push[i]) > friction[i])
+            heading = push[i] > 0 ? 1 : -1;
+        direction[i] = friction[i] > 0 ? heading : 0;
+        slide[i] = heading * friction[i];
+        moving[i] = heading != 0 ? 1 : 0;
+        return moving[i] != 0;
+    }
+};
+
+// Time in [0, 1] of the step where component c of the interpolant r crosses zero, r(0) and r(1) on opposite sides
+double locate_event(const double (&r)[ForceTrajectory::COEFFICIENTS][N], std::size_t c){
+    auto value = [&](double theta){
+        const double rest = 1 - theta;
+        return r[0][c] + theta * (r[1][c] + rest * (r[2][c] + theta * (r[3][c] + rest * r[4][c])));
+    };
+    const bool rising = value(0) < 0;
+    double low = 0, high = 1;
+    for (int i = 0; i < EVENT_BISECTIONS; i++){
+        const double middle = 0.5 * (low + high);
+        if ((value(middle) < 0) == rising)
+            low = middle;
+        else
+            high = middle;
+    }
+    return high;
+}
+
+// Stage values of one tile of slots, small enough to stay in cache while every stage of the tile is computed
+struct tile_stages{
+    double stage[STAGES][N][TILE_SLOTS];
+    double next[N][TILE_SLOTS]; // 5th order solution, where the last stage was taken
+    double error[TILE_SLOTS];
+};
+
+std::vector<ForceRun> integrate_bodies(const std::vector<ForceBody> &bodies, const ForceSettings &settings){
+    using clock = std::chrono::steady_clock;
+    const std::size_t count = bodies.size();
+    std::vector<ForceRun> runs(count);
+
+    body_columns b {};
+    b.resize(count);
+    std::size_t active = count;
+
+    // Closes the trajectory of slot i, the slot is dropped at the end of the round
+    auto finish = [&](std::size_t i, ForceEnd reason){
+        ForceRun &run = runs[b.body[i]];
+        run.end = reason;
+        run.trajectory.finish(b.t[i]);
+        b.alive[i] = 0;
+    };
+    // Ends slot i where it is, a block at rest stays there until its end time
+    auto rest = [&](std::size_t i, ForceEnd reason){
+        if (settings.keep_trajectories)
+            runs[b.body[i]].trajectory.add_rest(b.t[i], {b.state[X][i], b.state[Y][i], 0, 0});
+        if (reason == ForceEnd::STOPPED)
+            b.t[i] = b.end[i];
+        finish(i, reason);
+    };
+    // Moves the slots still alive to the front, in order
+    auto compact = [&](){
+        std::size_t kept {};
+        for (std::size_t i = 0; i < active; i++){
+            if (!b.alive[i])
+                continue;
+            if (kept != i)
+                b.move_slot(i, kept);
+            kept++;
+        }
+        active = kept;
+    };
+
+    for (std::size_t i = 0; i < count; i++){
+        const ForceBody &body = bodies[i];
+        const bool block = body.kind == BodyKind::BLOCK;
+        const double g = body.acc < 0 ? -body.acc : 0;
+        b.body[i] = i;
+        b.end[i] = body.end_time > 0 ? body.end_time : 0;
+        b.state[X][i] = body.x;
+        b.state[Y][i] = body.y;
+        b.state[VX][i] = body.vx;
+        b.state[VY][i] = block ? 0 : body.vy;
+        b.push[i] = block ? body.force / body.mass : 0;
+        b.friction[i] = block ? body.friction * g : 0;
+        b.linear[i] = body.linear_drag / body.mass;
+        b.quadratic[i] = body.quadratic_drag / body.mass;
+        b.gravity[i] = block ? 0 : body.acc;
+        b.airborne[i] = block ? 0 : 1;
+        b.moving[i] = 1;
+        b.alive[i] = 1;
+
+        // Bodies that never move, or are on the ground and heading down, are done before the first step
+        const bool moving = block ? b.set_friction(i, body.vx) : true;
+        if (b.end[i] == 0 || !moving){
+            rest(i, block ? ForceEnd::STOPPED : ForceEnd::TIME_LIMIT);
+            continue;
+        }
+        if (!block && body.y <= 0 && body.vy <= 0){
+            rest(i, ForceEnd::LANDED);
+            continue;
+        }
+        b.refresh_first(i);
+        runs[i].evaluations++;
+
+        // First guess: a step that changes the state by about 1% of its size (Hairer's h0)
+        double state_norm {}, rate_norm {};
+        for (std::size_t c = 0; c < N; c++){
+            const double scale = settings.absolute_tolerance + settings.relative_tolerance * std::fabs(b.state[c][i]);
+            state_norm += (b.state[c][i] / scale) * (b.state[c][i] / scale);
+            rate_norm += (b.first[c][i] / scale) * (b.first[c][i] / scale);
+        }
+        const double guess = state_norm < 1e-10 || rate_norm < 1e-10 ? 1e-6 : 0.01 * std::sqrt(state_norm / rate_norm);
+        b.h[i] = std::min(guess, b.end[i]);
+    }
+    compact();
+
+    std::unique_ptr<tile_stages> work = std::make_unique<tile_stages>();
+    while (active > 0){
+        const clock::time_point round_start = clock::now();
+
+        for (std::size_t tile = 0; tile < active; tile += TILE_SLOTS){
+            const std::size_t slots = std::min(TILE_SLOTS, active - tile);
+            auto &stage = work->stage;
+            auto &next = work->next;
+
+            // Every stage for every slot of the tile, one stage at a time
+            for (std::size_t c = 0; c < N; c++)
+                std::copy(b.first[c].begin() + tile, b.first[c].begin() + tile + slots, stage[0][c]);
+            for (std::size_t s = 1; s < STAGES; s++){
+                for (std::size_t k = 0; k < slots; k++){
+                    const std::size_t i = tile + k;
+                    double z[N], dz[N];
+                    for (std::size_t c = 0; c < N; c++){
+                        double sum {};
+                        for (std::size_t j = 0; j < s; j++)
+                            sum += DOPRI_A[s][j] * stage[j][c][k];
+                        z[c] = b.state[c][i] + b.h[i] * sum;
+                    }
+                    b.derivative(i, z, dz);
+                    for (std::size_t c = 0; c < N; c++)
+                        stage[s][c][k] = dz[c];
+                    if (s == STAGES - 1){
+                        for (std::size_t c = 0; c < N; c++)
+                            next[c][k] = z[c];
+                    }
+                }
+            }
+
+            // Scaled RMS error of every slot
+            for (std::size_t k = 0; k < slots; k++){
+                const std::size_t i = tile + k;
+                double sum {};
+                for (std::size_t c = 0; c < N; c++){
+                    double difference {};
+                    for (std::size_t j = 0; j < STAGES; j++)
+                        difference += DOPRI_E[j] * stage[j][c][k];
+                    const double scale = settings.absolute_tolerance + settings.relative_tolerance * std::max(std::fabs(b.state[c][i]), std::fabs(next[c][k]));
+                    const double e = b.h[i] * difference / scale;
+                    sum += e * e;
+                }
+                work->error[k] = std::sqrt(sum / N);
+            }
+
+            // Accept or reject, then place events
+            for (std::size_t k = 0; k < slots; k++){
+                const std::size_t i = tile + k;
+                ForceRun &run = runs[b.body[i]];
+                run.evaluations += STAGES - 1;
+                const double err = work->error[k];
+                const double scale = err > 0 ? STEP_SAFETY * std::pow(err, -0.2) : MAX_STEP_SCALE;
+
+                if (err > 1){
+                    run.rejected_steps++;
+                    b.h[i] *= std::max(MIN_STEP_SCALE, scale);
+                    b.rejected[i] = 1;
+                    if (run.accepted_steps + run.rejected_steps >= settings.max_steps)
+                        finish(i, ForceEnd::STEP_LIMIT);
+                    continue;
+                }
+
+                // Interpolant of the accepted step
+                const double h = b.h[i];
+                double r[ForceTrajectory::COEFFICIENTS][N] {};
+                for (std::size_t c = 0; c < N; c++){
+                    double dense {};
+                    for (std::size_t j = 0; j < STAGES; j++)
+                        dense += DOPRI_D[j] * stage[j][c][k];
+                    const double change = next[c][k] - b.state[c][i], bend = h * stage[0][c][k] - change;
+                    r[0][c] = b.state[c][i];
+                    r[1][c] = change;
+                    r[2][c] = bend;
+                    r[3][c] = change - h * stage[STAGES - 1][c][k] - bend;
+                    r[4][c] = h * dense;
+                }
+                run.accepted_steps++;
+                if (settings.keep_trajectories)
+                    run.trajectory.add_step(b.t[i], h, r);
+
+                // Events cut the step short at the crossing, the interpolant is still exact up to there
+                const bool block = b.airborne[i] == 0;
+                const bool stops = block && b.direction[i] != 0 && next[VX][k] * b.direction[i] <= 0;
+                const bool lands = !block && next[Y][k] < 0;
+                double theta = 1;
+                if (stops && next[VX][k] != 0)
+                    theta = locate_event(r, VX);
+                else if (lands)
+                    theta = locate_event(r, Y);
+
+                const double rest_theta = 1 - theta;
+                for (std::size_t c = 0; c < N; c++)
+                    b.state[c][i] = theta == 1 ? next[c][k] : r[0][c] + theta * (r[1][c] + rest_theta * (r[2][c] + theta * (r[3][c] + rest_theta * r[4][c])));
+                b.t[i] += theta * h;
+                const bool after_rejection = b.rejected[i] != 0;
+                b.rejected[i] = 0;
+
+                if (lands){
+                    b.state[Y][i] = 0;
+                    finish(i, ForceEnd::LANDED);
+                    continue;
+                }
+                if (stops){
+                    b.state[VX][i] = 0;
+                    if (!b.set_friction(i, 0)){
+                        rest(i, ForceEnd::STOPPED);
+                        continue;
+                    }
+                    b.refresh_first(i); // The forces changed, the last stage no longer is the derivative
+                    run.evaluations++;
+                }
+                else{
+                    for (std::size_t c = 0; c < N; c++)
+                        b.first[c][i] = stage[STAGES - 1][c][k];
+                }
+
+                if (b.t[i] >= b.end[i]){
+                    b.t[i] = b.end[i];
+                    finish(i, ForceEnd::TIME_LIMIT);
+                    continue;
+                }
+                if (run.accepted_steps + run.rejected_steps >= settings.max_steps){
+                    finish(i, ForceEnd::STEP_LIMIT);
+                    continue;
+                }
+                const double grow = after_rejection ? std::min(1.0, scale) : std::min(MAX_STEP_SCALE, std::max(MIN_STEP_SCALE, scale));
+                b.h[i] = std::min(h * grow, b.end[i] - b.t[i]);
+            }
+        }
+
+        // Wall time of the round, split evenly between the bodies that took part
+        const double share = std::chrono::duration<double>(clock::now() - round_start).count() / active;
+        for (std::size_t i = 0; i < active; i++)
+            runs[b.body[i]].seconds += share;
+        compact();
+    }
+    return runs;
+}
+
+InputCheck make_force_body(const ParameterValues &parameters, BodyKind kind, double linear_drag, double quadratic_drag, ForceBody &body){
+    const bool block = kind == BodyKind::BLOCK;
+    const Parameter used[] {Parameter::MASS, Parameter::TIME, Parameter::ACC, Parameter::INITIAL_SPEED,
+                            block ? Parameter::FORCE : Parameter::ANGLE, block ? Parameter::COEFF_FRICTION : Parameter::Y_INITIAL};
+    for (Parameter parameter : used){
+        const ParameterInfo &info = parameter_info(parameter);
+        const double value = parameters[parameter];
+        if (value != 0.0 && (value < info.min || value > info.max))
+            return {InputError::OUT_OF_RANGE, parameter, {}, value};
+    }
+    if (parameters[Parameter::MASS] == 0.0)
+        return {InputError::MISSING_FORCE_INPUT, Parameter::MASS};
+    if (block && parameters[Parameter::TIME] == 0.0)
+        return {InputError::MISSING_FORCE_INPUT, Parameter::TIME};
+    if (linear_drag < 0 || quadratic_drag < 0)
+        return {InputError::INVALID_DRAG};
+
+    body = {};
+    body.kind = kind;
+    body.mass = parameters[Parameter::MASS];
+    body.linear_drag = linear_drag;
+    body.quadratic_drag = quadratic_drag;
+    body.acc = parameters[Parameter::ACC] != 0.0 ? parameters[Parameter::ACC] : STANDARD_GRAVITY;
+    body.end_time = parameters[Parameter::TIME] != 0.0 ? parameters[Parameter::TIME] : parameter_info(Parameter::TIME).max;
+    if (block){
+        body.force = parameters[Parameter::FORCE];
+        body.friction = parameters[Parameter::COEFF_FRICTION];
+        body.vx = parameters[Parameter::INITIAL_SPEED];
+    }
+    else{
+        const double radians = parameters[Parameter::ANGLE] * (M_PI / 180.0);
+        body.y = parameters[Parameter::Y_INITIAL];
+        body.vx = parameters[Parameter::INITIAL_SPEED] * std::cos(radians);
+        body.vy = parameters[Parameter::INITIAL_SPEED] * std::sin(radians);
+    }
+    return {};
+}
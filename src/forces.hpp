@@ -0,0 +1,89 @@
+#pragma once
+
+// Forces engine: bodies moved by the forces acting on them, integrated numerically
+//  - BLOCK: slides along the ground, pushed by a constant horizontal force against Coulomb friction (the static
+//    and kinetic coefficients are the same)
+//  - PROJECTILE: flies under gravity until it is back on the ground
+// Both are slowed by linear (b v) and quadratic (c |v| v) air drag
+//
+// integrate_bodies() runs an adaptive Dormand-Prince 5(4) integrator over a whole batch at once: the state of
+// every body lives in structure-of-arrays columns and every round steps all of them once, each with its own step
+// size, a cache-sized tile of bodies at a time. Finished bodies are dropped from the columns after the round, so
+// the loops stay contiguous
+// Every accepted step keeps the coefficients of its 4th order interpolant (dense output), the motion can then be
+// sampled at any time without integrating again
+//
+// Friction jumps where the block stops and the projectile stops on the ground; both events are located on the
+// interpolant and the step is cut there, so no step integrates across a jump of the forces
+#include "kinematics_core.hpp"
+#include <cstddef>
+#include <vector>
+
+enum class BodyKind {BLOCK, PROJECTILE};
+
+const double STANDARD_GRAVITY {-9.81}; // Used while the table leaves the acceleration unknown
+
+struct ForceBody{
+    BodyKind kind {BodyKind::PROJECTILE};
+    double mass {1};                          // kg
+    double force {};                          // BLOCK: applied horizontal force (N)
+    double friction {};                       // BLOCK: Coulomb coefficient
+    double linear_drag {}, quadratic_drag {}; // N s/m and N s^2/m^2
+    double acc {STANDARD_GRAVITY};            // Gravity, < 0
+    double x {}, y {}, vx {}, vy {};          // Start, a block stays at y
+    double end_time {};                       // Integrated up to here unless the body lands or stops first
+};
+
+struct ForceState{
+    double x {}, y {}, vx {}, vy {};
+};
+
+// Dense output of one body: one interpolant per accepted step, each valid from its start to the next start
+class ForceTrajectory{
+    public:
+        static constexpr std::size_t COMPONENTS {4}, COEFFICIENTS {5}; // (x, y, vx, vy), 4th order interpolant
+
+    private:
+        struct segment{
+            double start, step;
+            double coefficients[COEFFICIENTS][COMPONENTS];
+        };
+        std::vector<segment> segments {};
+        double end {};
+
+    public:
+        // Adds the interpolant of a step that begins at t0 and was integrated with step size h
+        void add_step(double t0, double h, const double (&step_coefficients)[COEFFICIENTS][COMPONENTS]);
+        // Holds the state from t0 on
+        void add_rest(double t0, const ForceState &state);
+        void finish(double end_time) { end = end_time; }
+
+        // State at any time, clamped to [0, end_time()]
+        ForceState state_at(double t) const;
+        double end_time() const { return end; }
+        std::size_t steps() const { return segments.size(); }
+};
+
+// Why the integration of a body stopped
+enum class ForceEnd {TIME_LIMIT, LANDED, STOPPED, STEP_LIMIT};
+
+struct ForceRun{
+    ForceTrajectory trajectory {};
+    ForceEnd end {ForceEnd::TIME_LIMIT};
+    std::size_t accepted_steps {}, rejected_steps {}, evaluations {};
+    double seconds {}; // This body's share of the batch's wall time, every step round is split between the bodies in it
+};
+
+struct ForceSettings{
+    double relative_tolerance {1e-9}, absolute_tolerance {1e-9};
+    std::size_t max_steps {100000}; // Accepted and rejected, per body
+    bool keep_trajectories {true};  // Off when only the counts are needed, the trajectories then only hold their end time
+};
+
+// Integrates every body from t = 0, the runs come back in the order of the bodies
+std::vector<ForceRun> integrate_bodies(const std::vector<ForceBody> &bodies, const ForceSettings &settings = {});
+
+// Body of the Forces tab from the input table: mass, force, friction and time for a block (starting at
+// initial_speed), mass, speed, angle and initial height for a projectile; time is optional for a projectile
+// Returns why the table can not be integrated, the body is only complete when the check is ok
+InputCheck make_force_body(const ParameterValues &parameters, BodyKind kind, double linear_drag, double quadratic_drag, ForceBody &body);
@@ -0,0 +1,284 @@
+#include "height_solver.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Speed, launch angle (radians) and gravity (g = -acc > 0) of a launch, everything else is derived from them
+struct launch_state{
+    double v, theta, g;
+};
+const int STATE_COUNT {3}, DERIVED_COUNT {4};
+const unsigned STATE_BITS[STATE_COUNT] {KNOWN_V_INITIAL, KNOWN_ANGLE, KNOWN_ACC};
+const unsigned DERIVED_BITS[DERIVED_COUNT] {KNOWN_TIME, KNOWN_RANGE, KNOWN_MAX_HEIGHT, KNOWN_V_FINAL};
+
+// Time, range, max height and final speed of a state
+struct derived_quantities{
+    double value[DERIVED_COUNT];
+};
+
+derived_quantities derive(const launch_state &state, double y0){
+    const double v = state.v, g = state.g, s = std::sin(state.theta), c = std::cos(state.theta);
+    const double landing = std::sqrt(v * v * s * s + 2 * g * y0); // Vertical speed on landing, > 0 for y0 > 0
+    const double t = (v * s + landing) / g;
+    return {{t, v * c * t, v * v * s * s / (2 * g), std::sqrt(v * v + 2 * g * y0)}};
+}
+
+bool valid_state(const launch_state &state){
+    return std::isfinite(state.v) && std::isfinite(state.g) && state.v > 0 && state.g > 0 && state.theta >= 0 && state.theta <= M_PI / 2;
+}
+
+// Largest relative error of the known derived quantities
+double relative_residual(const derived_quantities &q, unsigned known, const double target[DERIVED_COUNT]){
+    double residual {};
+    for (int j = 0; j < DERIVED_COUNT; j++){
+        if (known & DERIVED_BITS[j])
+            residual = std::max(residual, std::fabs(q.value[j] - target[j]) / std::fabs(target[j]));
+    }
+    return residual;
+}
+
+// The missing one of speed, angle and gravity from a single derived quantity
+// Returns false when the known set has no closed form here, an impossible launch leaves NaN or an invalid state
+bool solve_closed_form(double y0, unsigned known, launch_state &state, const double target[DERIVED_COUNT]){
+    const double t = target[0], range = target[1], h = target[2], v_final = target[3];
+    const double s = std::sin(state.theta), c = std::cos(state.theta);
+    double &v = state.v, &g = state.g;
+
+    if (!(known & KNOWN_V_INITIAL)){
+        if (known & KNOWN_TIME)              v = (g * t * t / 2 - y0) / (t * s);
+        else if (known & KNOWN_RANGE)        v = std::sqrt(g * range * range / (2 * c * c * (y0 + range * s / c)));
+        else if (known & KNOWN_MAX_HEIGHT)   v = std::sqrt(2 * g * h) / s;
+        else                                 v = std::sqrt(v_final * v_final - 2 * g * y0);
+    }
+    else if (!(known & KNOWN_ACC)){
+        if (known & KNOWN_TIME)              g = 2 * (y0 + v * s * t) / (t * t);
+        else if (known & KNOWN_RANGE)        g = 2 * (y0 + v * s * (range / (v * c))) / ((range / (v * c)) * (range / (v * c)));
+        else if (known & KNOWN_MAX_HEIGHT)   g = v * v * s * s / (2 * h);
+        else                                 g = (v_final * v_final - v * v) / (2 * y0);
+    }
+    else{
+        if (known & KNOWN_TIME)              state.theta = std::asin((g * t * t / 2 - y0) / (v * t));
+        else if (known & KNOWN_MAX_HEIGHT)   state.theta = std::asin(std::sqrt(2 * g * h) / v);
+        else if (known & KNOWN_RANGE){
+            // Arcs through (range, -y0), tan(theta) of the low one from the product of the two roots (see targeting.hpp)
+            // The low arc is taken unless it has to be thrown downwards
+            const double v2 = v * v, lift = g * range * range - 2 * y0 * v2, sum = v2 + std::sqrt(v2 * v2 - g * lift);
+            state.theta = lift >= 0 ? std::atan(lift / (range * sum)) : std::atan(sum / (g * range));
+        }
+        else
+            return false; // The final speed does not depend on the angle
+    }
+    return true;
+}
+
+// Solves J dx = -r with partial pivoting, false when J is singular
+bool solve_linear(double J[3][3], double r[3], double dx[3]){
+    for (int k = 0; k < 3; k++){
+        int pivot = k;
+        for (int i = k + 1; i < 3; i++){
+            if (std::fabs(J[i][k]) > std::fabs(J[pivot][k]))
+                pivot = i;
+        }
+        if (!(std::fabs(J[pivot][k]) > 1e-200))
+            return false;
+        std::swap(J[k], J[pivot]);
+        std::swap(r[k], r[pivot]);
+        for (int i = k + 1; i < 3; i++){
+            const double factor = J[i][k] / J[k][k];
+            for (int j = k; j < 3; j++)
+                J[i][j] -= factor * J[k][j];
+            r[i] -= factor * r[k];
+        }
+    }
+    for (int k = 2; k >= 0; k--){
+        double sum = -r[k];
+        for (int j = k + 1; j < 3; j++)
+            sum -= J[k][j] * dx[j];
+        dx[k] = sum / J[k][k];
+    }
+    return true;
+}
+
+// Newton works on the velocity components and gravity instead: every quantity is algebraic in (vx, vy, g), so an
+// iteration costs a few square roots and no trigonometry, and pairs like time + range give vx right away
+struct component_state{
+    double vx, vy, g;
+};
+
+// Every known quantity of the launch, the angle as its sine and cosine and the rest as reciprocals, so the
+// relative errors need no divisions
+struct known_targets{
+    unsigned known;
+    double sin_theta, cos_theta;
+    double inverse_v, inverse_g, inverse_time, inverse_range, inverse_max_height, inverse_v_final;
+};
+
+// Relative error of the three known quantities and its partial derivatives by vx, vy and g
+// The angle's error is the sine of the angle between the velocity and the known direction
+struct component_errors{
+    double value[3], slope[3][3];
+    double largest;
+};
+
+component_errors errors_at(const component_state &x, double y0, const known_targets &k){
+    const double speed = std::sqrt(x.vx * x.vx + x.vy * x.vy);
+    const double landing = std::sqrt(x.vy * x.vy + 2 * x.g * y0);
+    const double t = (x.vy + landing) / x.g, dt_dvy = t / landing, dt_dg = (y0 / landing - t) / x.g;
+
+    component_errors e {};
+    int row {};
+    auto add = [&](double error, double d_vx, double d_vy, double d_g){
+        e.value[row] = error;
+        e.slope[row][0] = d_vx; e.slope[row][1] = d_vy; e.slope[row][2] = d_g;
+        e.largest = std::max(e.largest, std::fabs(error));
+        row++;
+    };
+    if (k.known & KNOWN_V_INITIAL){
+        const double scale = k.inverse_v / speed;
+        add(speed * k.inverse_v - 1, x.vx * scale, x.vy * scale, 0);
+    }
+    if (k.known & KNOWN_ANGLE){
+        const double inverse_speed = 1 / speed, error = (x.vy * k.cos_theta - x.vx * k.sin_theta) * inverse_speed;
+        add(error, (-k.sin_theta - error * x.vx * inverse_speed) * inverse_speed, (k.cos_theta - error * x.vy * inverse_speed) * inverse_speed, 0);
+    }
+    if (k.known & KNOWN_ACC)
+        add(x.g * k.inverse_g - 1, 0, 0, k.inverse_g);
+    if (k.known & KNOWN_TIME)
+        add(t * k.inverse_time - 1, 0, dt_dvy * k.inverse_time, dt_dg * k.inverse_time);
+    if (k.known & KNOWN_RANGE)
+        add(x.vx * t * k.inverse_range - 1, t * k.inverse_range, x.vx * dt_dvy * k.inverse_range, x.vx * dt_dg * k.inverse_range);
+    if (k.known & KNOWN_MAX_HEIGHT){
+        const double h = x.vy * x.vy / (2 * x.g);
+        add(h * k.inverse_max_height - 1, 0, x.vy / x.g * k.inverse_max_height, -h / x.g * k.inverse_max_height);
+    }
+    if (k.known & KNOWN_V_FINAL){
+        const double v_final = std::sqrt(speed * speed + 2 * x.g * y0), scale = k.inverse_v_final / v_final;
+        add(v_final * k.inverse_v_final - 1, x.vx * scale, x.vy * scale, y0 * scale);
+    }
+    return e;
+}
+
+// Damped Newton iteration from one start
+// Steps are halved until the largest error goes down; vx and g never drop below a tenth of their last value and
+// vy never below 0, so the launch stays in [0, 90] degrees
+bool newton_from(double y0, const known_targets &k, component_state &x, int &iterations){
+    component_errors e = errors_at(x, y0, k);
+    for (int iteration = 0; iteration < HEIGHT_MAX_ITERATIONS; iteration++){
+        if (e.largest <= HEIGHT_TOLERANCE)
+            return true;
+        iterations++;
+
+        double dx[3];
+        if (!solve_linear(e.slope, e.value, dx))
+            return false;
+
+        bool improved {false};
+        for (double damping = 1; damping > 1e-4 && !improved; damping /= 2){
+            const component_state trial {std::max(x.vx + damping * dx[0], x.vx / 10), std::max(x.vy + damping * dx[1], 0.0),
+                                         std::max(x.g + damping * dx[2], x.g / 10)};
+            const component_errors trial_errors = errors_at(trial, y0, k);
+            if (trial_errors.largest < e.largest){
+                x = trial;
+                e = trial_errors;
+                improved = true;
+            }
+        }
+        if (!improved)
+            return false; // Stuck in a local minimum of the error, or the known values contradict each other
+    }
+    return e.largest <= HEIGHT_TOLERANCE;
+}
+
+bool height_known_set_supported(unsigned known){
+    for (unsigned free_set : HEIGHT_UNDERDETERMINED_SETS){
+        if (known == free_set)
+            return false;
+    }
+    return true;
+}
+
+HeightSolveReport solve_launch_from_height(double y_initial, unsigned known, HeightLaunch &launch){
+    HeightSolveReport report {};
+    const double target[DERIVED_COUNT] {launch.time, launch.range, launch.max_height, launch.v_final};
+    unsigned known_states {}, known_derived {};
+    for (int k = 0; k < STATE_COUNT; k++)
+        known_states += (known & STATE_BITS[k]) != 0;
+    for (int j = 0; j < DERIVED_COUNT; j++)
+        known_derived += (known & DERIVED_BITS[j]) != 0;
+    if (known_states + known_derived != 3 || !height_known_set_supported(known) || !(y_initial > 0))
+        return report;
+
+    launch_state state {launch.v_initial, launch.angle * (M_PI / 180.0), -launch.acc};
+    bool solved {false};
+
+    if (known_derived <= 1){
+        report.method = HeightMethod::CLOSED_FORM;
+        solved = known_derived == 0 || solve_closed_form(y_initial, known, state, target);
+    }
+    else{
+        report.method = HeightMethod::NEWTON;
+        const double y0 = y_initial;
+        const double v = launch.v_initial, time = launch.time, range = launch.range, max_height = launch.max_height, v_final = launch.v_final;
+        const bool angle_known = known & KNOWN_ANGLE;
+        const known_targets k {known, angle_known ? std::sin(state.theta) : 0, angle_known ? std::cos(state.theta) : 1, 1 / v, 1 / state.g, 1 / time, 1 / range, 1 / max_height, 1 / v_final};
+
+        // Start from what the known values give directly, exact wherever a pair of them fixes a component:
+        // vx = range / time; vy from the apex height, the angle or the speed; gravity from apex and time, from both
+        // speeds or from the flight time once vy is known, else earth's. Restarts scale the first guess of vy
+        const bool range_and_time = (known & KNOWN_RANGE) && (known & KNOWN_TIME);
+        const double vx_exact = range_and_time ? range / time : 0;
+        double g = state.g;
+        bool exact_g = known & KNOWN_ACC;
+        if (!exact_g && (known & KNOWN_TIME) && (known & KNOWN_MAX_HEIGHT)){
+            g = std::pow((std::sqrt(2 * max_height) + std::sqrt(2 * (max_height + y0))) / time, 2);
+            exact_g = true;
+        }
+        else if (!exact_g && (known & KNOWN_V_INITIAL) && (known & KNOWN_V_FINAL)){
+            g = (v_final * v_final - v * v) / (2 * y0);
+            exact_g = true;
+        }
+
+        double vy {};
+        if (range_and_time && (known & KNOWN_ANGLE))             vy = vx_exact * k.sin_theta / k.cos_theta;
+        else if (range_and_time && (known & KNOWN_V_INITIAL))    vy = std::sqrt(std::max(v * v - vx_exact * vx_exact, 0.0));
+        else if ((known & KNOWN_V_INITIAL) && (known & KNOWN_ANGLE)) vy = v * k.sin_theta;
+        else{
+            g = exact_g ? g : 9.81;
+            vy = (known & KNOWN_MAX_HEIGHT) ? std::sqrt(2 * g * max_height)
+               : (known & KNOWN_TIME) ? std::max((g * time * time / 2 - y0) / time, 0.1 * g * time)
+               : (known & KNOWN_V_INITIAL) ? v * M_SQRT1_2
+               : (known & KNOWN_V_FINAL) ? std::sqrt(std::max(v_final * v_final - 2 * g * y0, 0.0) / 2)
+               : std::sqrt(g * range / 2);
+        }
+        if (!exact_g)
+            g = (known & KNOWN_TIME) ? 2 * (vy * time + y0) / (time * time) : 9.81;
+
+        for (double scale : {1.0, 0.3, 3.0}){
+            component_state x {0, std::max(vy * scale, 1e-3), g};
+            const double t = (x.vy + std::sqrt(x.vy * x.vy + 2 * x.g * y0)) / x.g;
+            const double floor = x.vy / 1000;
+            if (range_and_time)                                  x.vx = vx_exact;
+            else if ((known & KNOWN_ANGLE) && k.sin_theta > 0)   x.vx = x.vy * k.cos_theta / k.sin_theta;
+            else if (known & KNOWN_V_INITIAL)                    x.vx = std::sqrt(std::max(v * v - x.vy * x.vy, floor * floor));
+            else if (known & KNOWN_V_FINAL)                      x.vx = std::sqrt(std::max(v_final * v_final - x.vy * x.vy - 2 * x.g * y0, floor * floor));
+            else if (known & KNOWN_RANGE)                        x.vx = range / t;
+            else                                                 x.vx = x.vy;
+
+            if (newton_from(y0, k, x, report.iterations)){
+                state = {std::sqrt(x.vx * x.vx + x.vy * x.vy), std::atan2(x.vy, x.vx), x.g};
+                solved = true;
+                break;
+            }
+        }
+    }
+
+    if (!solved || !valid_state(state))
+        return report;
+    const derived_quantities q = derive(state, y_initial);
+    report.residual = relative_residual(q, known, target);
+    if (!(report.residual <= std::sqrt(HEIGHT_TOLERANCE))) // Closed forms of contradicting values land far off
+        return report;
+
+    launch = {state.v, state.theta * (180.0 / M_PI), -state.g, q.value[0], q.value[1], q.value[2], q.value[3]};
+    report.converged = true;
+    return report;
+}
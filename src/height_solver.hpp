@@ -0,0 +1,44 @@
+#pragma once
+
+// General solver for launches from a height (y_initial > 0), where the symmetric cases of solver_cases.hpp do not apply
+// A launch is fixed by its speed, angle and acceleration and every other quantity follows from those three, so any
+// three knowns out of {v_initial, angle, acc, time, range, max_height, v_final} pin it down:
+//  - two or three of speed, angle and acceleration known: the missing one has a closed form (the low arc when
+//    the angle is found from the range)
+//  - otherwise the missing ones are found with a damped Newton iteration on the known quantities, with the
+//    analytic Jacobian and restarts from a few launch angles
+// max_height is measured from the launch point like in the symmetric solver, time and range end on the ground
+//
+// Three sets do not pin the launch down and are rejected: angle + range + max_height and acc + time + max_height
+// leave gravity or the angle free, v_initial + acc + v_final says nothing about the angle
+#include <cstdint>
+
+enum HeightKnownBit : unsigned {KNOWN_V_INITIAL = 1, KNOWN_ANGLE = 2, KNOWN_ACC = 4, KNOWN_TIME = 8, KNOWN_RANGE = 16, KNOWN_MAX_HEIGHT = 32,
+                                KNOWN_V_FINAL = 64};
+
+// Every quantity of a launch from a height, the known ones are inputs and the rest is filled in
+struct HeightLaunch{
+    double v_initial {}, angle {}, acc {}; // angle in degrees, acc < 0
+    double time {}, range {}, max_height {}, v_final {};
+};
+
+enum class HeightMethod {CLOSED_FORM, NEWTON};
+
+struct HeightSolveReport{
+    HeightMethod method {HeightMethod::CLOSED_FORM};
+    bool converged {false};
+    int iterations {};     // Newton iterations over every restart, 0 for closed forms
+    double residual {};    // Largest relative error of a known quantity at the solution
+};
+
+const int HEIGHT_MAX_ITERATIONS {40};  // Per restart
+const double HEIGHT_TOLERANCE {1e-12}; // Relative, on every known quantity
+inline constexpr unsigned HEIGHT_UNDERDETERMINED_SETS[] {KNOWN_ANGLE | KNOWN_RANGE | KNOWN_MAX_HEIGHT, KNOWN_ACC | KNOWN_TIME | KNOWN_MAX_HEIGHT,
+                                                         KNOWN_V_INITIAL | KNOWN_ACC | KNOWN_V_FINAL};
+
+// Whether three known quantities fix a launch from a height
+bool height_known_set_supported(unsigned known);
+
+// Solves the launch for the `known` quantities (HeightKnownBit), needs exactly three of them
+// The launch is only changed when the report says converged
+HeightSolveReport solve_launch_from_height(double y_initial, unsigned known, HeightLaunch &launch);
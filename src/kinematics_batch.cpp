@@ -0,0 +1,253 @@
+// Headless batch solver
+// Streams scenarios from a CSV/TSV file (or stdin), solves them on a thread pool with the SIMD batch solver
+// and writes the results back in input order, as CSV/TSV or as a columnar binary file
+#include "batch_solver.hpp"
+#include "columnar_export.hpp"
+#include "kinematics_core.hpp"
+#include "scenario_loader.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Constant config values
+const std::size_t DEFAULT_CHUNK_ROWS {65536}, ROWS_PER_TASK {256};
+
+struct BatchOptions{
+    std::string input_path {"-"}, output_path {"-"};
+    unsigned int thread_count {0};
+    std::size_t chunk_rows {DEFAULT_CHUNK_ROWS};
+    ExportFormat format {ExportFormat::CSV};
+};
+
+// Values stored per row in binary output: every parameter, then the status (1 solved, 0 rejected)
+const std::size_t BINARY_COLUMNS {PARAMETER_COUNT + 1};
+
+void print_usage(){
+    std::cerr << "Usage: kinematics_batch [-o output] [-f format] [-j threads] [-c chunk_rows] [input]\n"
+                 "  input       CSV or TSV file with a header row of parameter names, '-' or nothing reads stdin\n"
+                 "  -o output   result file, '-' or nothing writes stdout\n"
+                 "  -f format   csv (default, same delimiter as the input) or binary (columnar, needs -o, no error messages)\n"
+                 "  -j threads  worker threads, 0 uses every hardware thread (default 0)\n"
+                 "  -c rows     rows read and solved per chunk (default " << DEFAULT_CHUNK_ROWS << ")\n";
+}
+
+bool parse_options(int argc, char **argv, BatchOptions &options){
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if ((arg == "-o" || arg == "-f" || arg == "-j" || arg == "-c") && i + 1 < argc){
+            std::string value = argv[++i];
+            if (arg == "-o")
+                options.output_path = value;
+            else if (arg == "-f"){
+                if (value != "csv" && value != "binary")
+                    return false;
+                options.format = value == "csv" ? ExportFormat::CSV : ExportFormat::BINARY;
+            }
+            else if (arg == "-j")
+                options.thread_count = static_cast<unsigned int>(std::strtoul(value.c_str(), nullptr, 10));
+            else
+                options.chunk_rows = std::max<std::size_t>(1, std::strtoull(value.c_str(), nullptr, 10));
+        }
+        else if (arg == "-h" || arg == "--help" || (arg.size() > 1 && arg[0] == '-'))
+            return false;
+        else
+            options.input_path = arg;
+    }
+    // Binary output is written through a memory-mapped file, which stdout can not be
+    return options.format == ExportFormat::CSV || options.output_path != "-";
+}
+
+// Error messages can hold newlines and delimiters, so they are always written as a quoted field
+std::string quote_field(const std::string &text){
+    std::string quoted {"\""};
+    for (char c : text){
+        if (c == '"')
+            quoted += "\"\"";
+        else if (c == '\n')
+            quoted += ' ';
+        else
+            quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Scratch of one pool task, reused for every block of rows it solves
+struct RowBlock{
+    ScenarioBatch batch {};
+    std::vector<char> rejected {}; // Rows already passed to the callback, their lanes are solved but not used
+};
+
+// Parses the rows [begin, end) of a chunk straight into the lanes of block.batch and solves them with find_unknown_batch()
+// Calls done(row, parameters, error) once for every row, error is empty for rows that were solved
+// Rejected rows are handed over with their input values before the batch is solved
+template <typename Done>
+void solve_rows(const std::vector<std::string_view> &lines, std::size_t begin, std::size_t end, const ScenarioHeader &header, RowBlock &block,
+                Done done){
+    const std::size_t count = end - begin;
+    if (block.batch.size() != count)
+        block.batch.resize(count);
+    block.rejected.assign(count, 0);
+    const ScenarioColumns columns = block.batch.columns();
+
+    ParameterValues parameters {}; // The forces parameters have no lane and stay at their defaults
+    std::string error {};
+    for (std::size_t i = 0; i < count; i++){
+        error.clear();
+        const bool parsed = parse_scenario(lines[begin + i], header, columns, i, error);
+        columns.load(i, parameters);
+        if (parsed){
+            const InputCheck check = check_input(parameters);
+            if (!check.ok())
+                error = format_input_error(check);
+        }
+        if (!error.empty()){
+            block.rejected[i] = 1;
+            done(begin + i, parameters, error);
+        }
+    }
+
+    find_unknown_batch(columns);
+    for (std::size_t i = 0; i < count; i++){
+        if (block.rejected[i])
+            continue;
+        const InputCheck check = solved_lane_check(columns, i);
+        columns.load(i, parameters);
+        done(begin + i, parameters, check.ok() ? std::string{} : format_input_error(check));
+    }
+}
+
+// Formats the output row of a solved or rejected scenario
+void format_row(const ParameterValues &parameters, bool solved, const std::string &error_message, char delimiter, std::string &row){
+    row.clear();
+    char buffer[32];
+    for (double value : parameters.value){
+        // Same text as "%.10g", without the locale and format string overhead of snprintf
+        const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 10);
+        row.append(buffer, result.ptr);
+        row += delimiter;
+    }
+    row += solved ? "ok" : "error";
+    row += delimiter;
+    row += quote_field(error_message);
+    row += '\n';
+}
+
+int main(int argc, char **argv){
+    BatchOptions options {};
+    if (!parse_options(argc, argv, options)){
+        print_usage();
+        return 2;
+    }
+
+    // Open the input and output streams
+    scenario_source input {};
+    if (!input.open(options.input_path)){
+        std::cerr << input.last_error() << "\n";
+        return 1;
+    }
+
+    const bool binary = options.format == ExportFormat::BINARY;
+    std::ofstream output_file {};
+    if (options.output_path != "-" && !binary){
+        output_file.open(options.output_path);
+        if (!output_file){
+            std::cerr << "Could not open output file: " << options.output_path << "\n";
+            return 1;
+        }
+    }
+    std::ostream &output = options.output_path == "-" ? std::cout : output_file;
+    std::ios::sync_with_stdio(false);
+
+    // Read the header and map every column to its parameter
+    std::vector<std::string_view> lines {};
+    if (!input.next_lines(1, lines)){
+        std::cerr << "Input is empty, expected a header row of parameter names\n";
+        return 1;
+    }
+    ScenarioHeader header {};
+    std::string header_error {};
+    if (!parse_header(lines[0], header, header_error)){
+        std::cerr << header_error << "\n";
+        return 1;
+    }
+    const char delimiter = header.delimiter;
+
+    table_writer writer {};
+    if (binary){
+        std::vector<std::string> names {};
+        for (const ParameterInfo &info : PARAMETER_INFO)
+            names.push_back(info.name);
+        names.push_back("status");
+        if (!writer.open(options.output_path, ExportFormat::BINARY, names, nullptr)){
+            std::cerr << writer.last_error() << "\n";
+            return 1;
+        }
+    }
+    else{
+        for (const ParameterInfo &info : PARAMETER_INFO)
+            output << info.name << delimiter;
+        output << "status" << delimiter << "error\n";
+    }
+
+    // Solve the input chunk by chunk, so memory stays bounded no matter how large the input is
+    thread_pool pool {options.thread_count};
+    std::vector<std::string> results {};
+    std::vector<double> values {}; // BINARY_COLUMNS values per row in binary mode
+    std::vector<char> solved {};
+    std::vector<RowBlock> blocks((options.chunk_rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK); // One per task, reused for every chunk
+    std::size_t total_rows {}, failed_rows {};
+    auto start = std::chrono::steady_clock::now();
+
+    // Rows are views into the input, parsing and solving both run on the pool
+    while (input.next_lines(options.chunk_rows, lines)){
+        if (binary)
+            values.resize(lines.size() * BINARY_COLUMNS);
+        else
+            results.resize(lines.size());
+        solved.assign(lines.size(), 0);
+        pool.parallel_for(lines.size(), ROWS_PER_TASK, [&](std::size_t begin, std::size_t end){
+            solve_rows(lines, begin, end, header, blocks[begin / ROWS_PER_TASK],
+                [&](std::size_t i, const ParameterValues &parameters, const std::string &error_message){
+                    solved[i] = error_message.empty();
+                    if (binary){
+                        std::copy(std::begin(parameters.value), std::end(parameters.value), values.begin() + i * BINARY_COLUMNS);
+                        values[i * BINARY_COLUMNS + PARAMETER_COUNT] = solved[i] ? 1 : 0;
+                    }
+                    else
+                        format_row(parameters, solved[i], error_message, delimiter, results[i]);
+                });
+        });
+
+        // Results are written in input order once the whole chunk is solved
+        for (std::size_t i = 0; i < lines.size(); i++){
+            if (binary){
+                if (!writer.write_row(values.data() + i * BINARY_COLUMNS)){
+                    std::cerr << writer.last_error() << "\n";
+                    return 1;
+                }
+            }
+            else
+                output << results[i];
+            if (!solved[i])
+                failed_rows++;
+        }
+        total_rows += lines.size();
+    }
+    if (binary && !writer.close()){
+        std::cerr << writer.last_error() << "\n";
+        return 1;
+    }
+    output.flush();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Solved " << total_rows << " scenarios (" << failed_rows << " rejected) in " << seconds << " s using "
+              << pool.size() << " threads: " << (seconds > 0 ? total_rows / seconds : 0.0) << " scenarios/second\n";
+    return 0;
+}
@@ -0,0 +1,291 @@
+#include "kinematics_core.hpp"
+#include "height_solver.hpp"
+#include "solver_cases.hpp"
+#include <cmath>
+#include <cstdio>
+
+// Launches from a height, solved by solve_launch_from_height()
+// The velocity components stand in for speed and angle like below; the angle counts as known unless three other
+// quantities are given, then it is solved for as well
+SolveStatus find_unknown_from_height(double y_initial, double &v_initial, double &v_final, double &acc, double &time, double &max_height,
+                                     double &abs_max_height, double &range, double &angle, const double (&components)[4], double &apexTime,
+                                     HeightSolveReport *report){
+    HeightLaunch launch {v_initial, angle, acc, time, range, max_height, v_final};
+    if (components[0] != 0){
+        launch.v_initial = std::sqrt(components[0] * components[0] + components[1] * components[1]);
+        launch.angle = std::atan(std::abs(components[1] / components[0])) * (180.0 / M_PI);
+    }
+    if (components[2] != 0)
+        launch.v_final = std::sqrt(components[2] * components[2] + components[3] * components[3]);
+
+    unsigned known = (launch.v_initial != 0) * KNOWN_V_INITIAL | (launch.acc != 0) * KNOWN_ACC | (launch.time != 0) * KNOWN_TIME |
+                     (launch.range != 0) * KNOWN_RANGE | (launch.max_height != 0) * KNOWN_MAX_HEIGHT | (launch.v_final != 0) * KNOWN_V_FINAL;
+    const unsigned known_count = (known & KNOWN_V_INITIAL ? 1 : 0) + (known & KNOWN_ACC ? 1 : 0) + (known & KNOWN_TIME ? 1 : 0) +
+                                 (known & KNOWN_RANGE ? 1 : 0) + (known & KNOWN_MAX_HEIGHT ? 1 : 0) + (known & KNOWN_V_FINAL ? 1 : 0);
+    if (known_count == 2)
+        known |= KNOWN_ANGLE;
+    if ((known_count != 2 && known_count != 3) || !height_known_set_supported(known))
+        return SolveStatus::UNSUPPORTED_KNOWN_SET;
+
+    const HeightSolveReport result = solve_launch_from_height(y_initial, known, launch);
+    if (report != nullptr)
+        *report = result;
+    if (!result.converged)
+        return SolveStatus::NOT_CONVERGED;
+
+    v_initial = launch.v_initial; angle = launch.angle; acc = launch.acc;
+    time = launch.time; range = launch.range; max_height = launch.max_height; v_final = launch.v_final;
+    abs_max_height = y_initial + max_height;
+    apexTime = -v_initial * std::sin(angle * (M_PI / 180.0)) / acc;
+    return SolveStatus::SOLVED;
+}
+
+// Physics Engine
+SolveStatus find_unknown(double &y_initial, double &v_initial, double &v_final, double &acc, double &time, double &max_height, double &abs_max_height, double &range, double &angle, double &v_initial_i_component, double &v_initial_j_component, double &v_final_i_component, double &v_final_j_component, double &apexTime, HeightSolveReport *report) {    
+    // y_initial  --> initial height of the projectile with respect to the ground
+    // v_initial  --> initial speed (non-vector) of projectile
+    // v_final    --> final speed (non-vector) of projectile
+    // acc        --> acceleration magnitude (non-vector) of projectile (vertical axis only)
+    // time       --> full period of motion of projectile
+    // max_height     --> Height / Vertical displacement of projectile
+    // range      --> Horizontal Distance Travalled by the Projectile
+    // angle      --> angle (degrees) with respect to the x-axis
+    // v_initial_i_component  --> initial horiztonal velocity vector component (always greater than 0)
+    // v_initial_j_component  --> initial vertical velocity vector component (either 0 or positive)
+    // v_final_i_component    --> final horizontal velocity vector component (always greater than 0)
+    // v_final_j_component    --> final vertical velocity component (either 0 or negative)
+
+    double theta {}; // Launch Angle: Used for symmetrical case (y_initil = 0)
+    //double theta1 {}; // Launch Angle: Used for asymmetrical case -- initial angle (y_initial > 0)
+    //double theta2 {}; // Impact Angle: Used for asymmetrical case -- final angle (y_initial > 0)
+
+    // The code below is responsible for checking and calculating two unknown parameters of the projectile
+    // by using the 3 known parameters. The three known parameters may be used to calculate both of the 
+    // remaining parameters, or solving for one can be further used to solve for the other.
+
+    if(y_initial != 0.0) // The symmetric cases below only hold for launches from the ground
+        return find_unknown_from_height(y_initial, v_initial, v_final, acc, time, max_height, abs_max_height, range, angle,
+                                        {v_initial_i_component, v_initial_j_component, v_final_i_component, v_final_j_component}, apexTime, report);
+
+    // Normalizing vector inputs below
+
+    if(v_initial_i_component != 0) { // only checking for initial i-component
+        v_initial = sqrt(pow(v_initial_i_component, 2) + pow(v_initial_j_component, 2));
+
+        theta = std::atan(std::abs(v_initial_j_component / v_initial_i_component));
+    }
+
+    else {theta = angle * (M_PI / 180.0);}
+
+    if(v_final_i_component != 0) { // only checking for final i-component
+        v_final = sqrt(pow(v_final_i_component, 2) + pow(v_final_j_component, 2));
+
+        theta = std::atan(std::abs(v_final_j_component / v_final_i_component));
+    }
+
+    else {theta = angle * (M_PI / 180.0);}
+
+    // The unknowns (values left at 0) pick the case directly, see solver_cases.hpp
+    const unsigned unknown = (v_initial == 0) * UNKNOWN_V_INITIAL | (v_final == 0) * UNKNOWN_V_FINAL | (acc == 0) * UNKNOWN_ACC |
+                             (time == 0) * UNKNOWN_TIME | (max_height == 0) * UNKNOWN_MAX_HEIGHT | (range == 0) * UNKNOWN_RANGE;
+    const case_solver solver = CASE_DISPATCH.solver[unknown];
+    if (solver == nullptr)
+        return SolveStatus::UNSUPPORTED_KNOWN_SET;
+
+    case_values<double> values {v_initial, v_final, acc, time, max_height, range, std::sin(theta), std::cos(theta)};
+    solver(values);
+    v_initial = values.v_initial; v_final = values.v_final; acc = values.acc;
+    time = values.time; max_height = values.max_height; range = values.range;
+
+    abs_max_height = y_initial + max_height; // Calculate maximum height (absolute) with respect to ground
+    apexTime = (-1 * v_initial * values.sin_theta) / acc; // Calculate or recalculate time the projectile needs to reach maximum height with respect to launch
+    return SolveStatus::SOLVED;
+}
+
+// Sets of parameters counted towards the required scalar and vector inputs
+constexpr ParameterMask required_mask(ParameterTable table){
+    ParameterMask mask {};
+    for (const ParameterInfo &info : PARAMETER_INFO){
+        if (info.is_required && (info.info_type == table || info.info_type == ParameterTable::BOTH))
+            mask |= parameter_bit(info.parameter);
+    }
+    return mask;
+}
+constexpr ParameterMask REQUIRED_SCALARS {required_mask(ParameterTable::KINEMATICS_SCALAR)};
+constexpr ParameterMask REQUIRED_VECTORS {required_mask(ParameterTable::KINEMATICS_VECTOR)};
+
+unsigned int count_bits(ParameterMask mask){
+    unsigned int count {};
+    for (; mask != 0; mask &= mask - 1)
+        count++;
+    return count;
+}
+
+// Lowest parameter in a non-empty mask
+Parameter first_parameter(ParameterMask mask){
+    unsigned int index {};
+    while (!(mask & 1)){
+        mask >>= 1;
+        index++;
+    }
+    return static_cast<Parameter>(index);
+}
+
+ParameterMask given_parameters(const ParameterValues &parameters){
+    ParameterMask given {};
+    for (std::size_t i = 0; i < PARAMETER_COUNT; i++){
+        if (parameters.value[i] != 0.0) // Default values are not given
+            given |= ParameterMask{1} << i;
+    }
+    return given;
+}
+
+// Verifies all input fields
+InputCheck check_input(const ParameterValues &parameters){
+    const ParameterMask given = given_parameters(parameters);
+
+    // Verify all values are inside their ranges
+    for (ParameterMask rest = given; rest != 0; rest &= rest - 1){
+        const ParameterInfo &info = parameter_info(first_parameter(rest));
+        const double value = parameters[info.parameter];
+        if (value < info.min || value > info.max)
+            return {InputError::OUT_OF_RANGE, info.parameter, {}, value};
+    }
+
+    // Check that all of the given variables have the required dependencies
+    for (ParameterMask rest = given; rest != 0; rest &= rest - 1){
+        const ParameterInfo &info = parameter_info(first_parameter(rest));
+        const ParameterMask missing = info.dependencies & ~given;
+        if (missing != 0)
+            return {InputError::MISSING_DEPENDENCY, info.parameter, first_parameter(missing)};
+    }
+
+    // Check if the threshold is reached, launches from a height count the angle as one of the inputs
+    const unsigned int required_scalar_count = count_bits(given & REQUIRED_SCALARS), required_vector_count = count_bits(given & REQUIRED_VECTORS);
+    const unsigned int angle_count = parameters[Parameter::Y_INITIAL] != 0.0 ? 1 : 0;
+    if (required_scalar_count + angle_count < 3 && required_vector_count < 3){
+        InputCheck check {InputError::NOT_ENOUGH_INPUTS};
+        check.scalar_count = required_scalar_count;
+        check.vector_count = required_vector_count;
+        return check;
+    }
+
+    // Verify initial and final velocities are the same if both are given, launches from a height land faster
+    if(parameters[Parameter::Y_INITIAL] == 0.0 && parameters[Parameter::INITIAL_SPEED] != 0.f && parameters[Parameter::FINAL_SPEED] != 0.f) {
+        if (parameters[Parameter::INITIAL_SPEED] != parameters[Parameter::FINAL_SPEED])
+            return {InputError::SPEED_MISMATCH};
+    }
+
+    if(parameters[Parameter::V_INITIAL_I_COMPONENT] != 0.f && parameters[Parameter::V_FINAL_I_COMPONENT] != 0.f) {
+        if(parameters[Parameter::V_INITIAL_I_COMPONENT] != parameters[Parameter::V_FINAL_I_COMPONENT])
+            return {InputError::I_COMPONENT_MISMATCH};
+    }
+
+    if(parameters[Parameter::V_INITIAL_J_COMPONENT] != 0.f && parameters[Parameter::V_FINAL_J_COMPONENT] != 0.f) {
+        if(parameters[Parameter::V_INITIAL_J_COMPONENT] != parameters[Parameter::V_FINAL_J_COMPONENT])
+            return {InputError::J_COMPONENT_MISMATCH};
+    }
+
+    return {};
+}
+
+// Verifies all input fields and calls the physics engine
+InputCheck cleanup_input(ParameterValues &parameters){
+    const InputCheck check = check_input(parameters);
+    if (!check.ok())
+        return check;
+
+    // Inputs look valid, call the physics engine
+    const SolveStatus status = find_unknown(
+        parameters[Parameter::Y_INITIAL],
+        parameters[Parameter::INITIAL_SPEED],
+        parameters[Parameter::FINAL_SPEED],
+        parameters[Parameter::ACC],
+        parameters[Parameter::TIME],
+        parameters[Parameter::MAX_HEIGHT],
+        parameters[Parameter::ABS_MAX_HEIGHT],
+        parameters[Parameter::RANGE],
+        parameters[Parameter::ANGLE],
+        parameters[Parameter::V_INITIAL_I_COMPONENT],
+        parameters[Parameter::V_INITIAL_J_COMPONENT],
+        parameters[Parameter::V_FINAL_I_COMPONENT],
+        parameters[Parameter::V_FINAL_J_COMPONENT],
+        parameters[Parameter::TIME_OF_APEX]
+    );
+
+    if (status == SolveStatus::NOT_CONVERGED)
+        return {InputError::NOT_CONVERGED};
+
+    if (status == SolveStatus::UNSUPPORTED_KNOWN_SET)
+        return {InputError::UNSUPPORTED_KNOWN_SET};
+
+    // Check output value -> <0 means the input values lead to an impossible case
+    if(parameters[Parameter::MAX_HEIGHT] < 0)
+        return {InputError::INCONSISTENT_VALUES};
+
+    return {};
+}
+
+void follow_launch_speed(const ParameterValues &base, ParameterValues &parameters){
+    if (base[Parameter::INITIAL_SPEED] == 0 || base[Parameter::FINAL_SPEED] == 0)
+        return;
+    if (parameters[Parameter::INITIAL_SPEED] != base[Parameter::INITIAL_SPEED])
+        parameters[Parameter::FINAL_SPEED] = parameters[Parameter::INITIAL_SPEED];
+    else if (parameters[Parameter::FINAL_SPEED] != base[Parameter::FINAL_SPEED])
+        parameters[Parameter::INITIAL_SPEED] = parameters[Parameter::FINAL_SPEED];
+}
+
+std::size_t format_input_error(const InputCheck &check, char *buffer, std::size_t size){
+    int length {};
+    switch (check.error){
+        case InputError::NONE:
+            length = std::snprintf(buffer, size, "%s", "");
+            break;
+        case InputError::OUT_OF_RANGE:
+            length = std::snprintf(buffer, size, "Parameter: %s with value: %f is not within allowed range [%d, %d]\nPlease enter valid and consistent values!",
+                                   parameter_info(check.parameter).name, check.value, parameter_info(check.parameter).min, parameter_info(check.parameter).max);
+            break;
+        case InputError::MISSING_DEPENDENCY:
+            length = std::snprintf(buffer, size, "Missing required dependency for parameter: %s: dependency %s not provided",
+                                   parameter_info(check.parameter).name, parameter_info(check.dependency).name);
+            break;
+        case InputError::NOT_ENOUGH_INPUTS:
+            length = std::snprintf(buffer, size, "Not enough required inputs. Required scalar count = %u, required vector count = %u",
+                                   check.scalar_count, check.vector_count);
+            break;
+        case InputError::SPEED_MISMATCH:
+            length = std::snprintf(buffer, size, "%s", "Initial and Final speed are NOT the same!");
+            break;
+        case InputError::I_COMPONENT_MISMATCH:
+            length = std::snprintf(buffer, size, "%s", "Initial and Final vertical (i) components are NOT the same!");
+            break;
+        case InputError::J_COMPONENT_MISMATCH:
+            length = std::snprintf(buffer, size, "%s", "Initial and Final Horizontal (j) components are NOT the same!");
+            break;
+        case InputError::NOT_CONVERGED:
+            length = std::snprintf(buffer, size, "%s", "No launch from this height matches the given values!\nCheck that they are consistent");
+            break;
+        case InputError::UNSUPPORTED_KNOWN_SET:
+            length = std::snprintf(buffer, size, "%s", "No solver for this combination of known values!\nLeave exactly three of: speed, final speed, acceleration, time, distance, maximum height empty");
+            break;
+        case InputError::INCONSISTENT_VALUES:
+            length = std::snprintf(buffer, size, "%s", "User has entered inconsistent values!\nLook at the calculated value of Maximum Height!");
+            break;
+        case InputError::NOT_SOLVED:
+            length = std::snprintf(buffer, size, "%s", "Can not play without values");
+            break;
+        case InputError::MISSING_FORCE_INPUT:
+            length = std::snprintf(buffer, size, "Forces need a value for: %s", parameter_info(check.parameter).name);
+            break;
+        case InputError::INVALID_DRAG:
+            length = std::snprintf(buffer, size, "%s", "Drag coefficients can not be negative!");
+            break;
+    }
+    return length > 0 ? static_cast<std::size_t>(length) : 0;
+}
+
+std::string format_input_error(const InputCheck &check){
+    std::string message (format_input_error(check, nullptr, 0), '\0');
+    format_input_error(check, message.data(), message.size() + 1);
+    return message;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+// Physics and input validation shared by the simulator GUI and the headless tools.
+// Nothing in here may depend on SFML, ImGui or any global GUI state.
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Enums to store parameter name and table
+enum class Parameter{V_INITIAL_I_COMPONENT, V_INITIAL_J_COMPONENT, V_FINAL_I_COMPONENT, V_FINAL_J_COMPONENT, Y_INITIAL, ACC, ANGLE, TIME, RANGE, ABS_MAX_HEIGHT, MAX_HEIGHT, TIME_OF_APEX, INITIAL_SPEED, FINAL_SPEED, COEFF_FRICTION, FORCE, MASS};
+enum class ParameterTable {KINEMATICS_SCALAR, KINEMATICS_VECTOR, FORCES, BOTH}; // Both is kinematic and scalar
+
+const std::size_t PARAMETER_COUNT {17};
+
+// One bit per Parameter, used for sets of parameters such as dependencies
+using ParameterMask = std::uint32_t;
+constexpr ParameterMask parameter_bit(Parameter parameter) { return ParameterMask{1} << static_cast<unsigned>(parameter); }
+
+// Static metadata about a parameter, never changes at runtime
+struct ParameterInfo{
+    Parameter parameter;
+    const char *name;
+
+    double default_value;
+    int min, max;
+
+    bool is_required;
+    ParameterTable info_type;
+    ParameterMask dependencies;
+};
+
+// Metadata of every parameter, indexed by Parameter
+inline constexpr ParameterInfo PARAMETER_INFO[PARAMETER_COUNT] {
+    {Parameter::V_INITIAL_I_COMPONENT, "v_initial_i_component", 0.0, 1, 1000, true, ParameterTable::KINEMATICS_VECTOR, parameter_bit(Parameter::V_INITIAL_J_COMPONENT)},
+    {Parameter::V_INITIAL_J_COMPONENT, "v_ininitial_j_component", 0.0, 1, 1000, true, ParameterTable::KINEMATICS_VECTOR, parameter_bit(Parameter::V_INITIAL_I_COMPONENT)},
+    {Parameter::V_FINAL_I_COMPONENT, "v_final_i_component", 0.0, 1, 1000, true, ParameterTable::KINEMATICS_VECTOR, parameter_bit(Parameter::V_FINAL_J_COMPONENT)},
+    {Parameter::V_FINAL_J_COMPONENT, "v_final_j_component", 0.0, 1, 1000, true, ParameterTable::KINEMATICS_VECTOR, parameter_bit(Parameter::V_FINAL_I_COMPONENT)},
+    {Parameter::Y_INITIAL, "y_initial", 0.0, 0, 1000, false, ParameterTable::BOTH, 0},
+    {Parameter::ACC, "acc", 0.0, -1000, -1, true, ParameterTable::BOTH, 0},
+    {Parameter::ANGLE, "angle", 45.0, 0, 90, false, ParameterTable::BOTH, 0},
+    {Parameter::TIME, "time", 0.0, 1, 1000, true, ParameterTable::BOTH, 0},
+    {Parameter::RANGE, "range", 0.0, 1, 1000, true, ParameterTable::BOTH, 0},
+    {Parameter::ABS_MAX_HEIGHT, "abs_max_height", 0.0, 1, 1000, false, ParameterTable::BOTH, 0},
+    {Parameter::MAX_HEIGHT, "max_height", 0.0, 1, 1000, true, ParameterTable::BOTH, 0},
+    {Parameter::TIME_OF_APEX, "apexTime", 0.0, 1, 1000, false, ParameterTable::BOTH, 0},
+    {Parameter::INITIAL_SPEED, "initial_speed", 0.0, 1, 1000, true, ParameterTable::KINEMATICS_SCALAR, 0},
+    {Parameter::FINAL_SPEED, "final_speed", 0.0, 1, 1000, true, ParameterTable::KINEMATICS_SCALAR, 0},
+    {Parameter::COEFF_FRICTION, "coeff_friction", 0.0, 0, 1, true, ParameterTable::FORCES, parameter_bit(Parameter::FORCE) | parameter_bit(Parameter::TIME) | parameter_bit(Parameter::MASS)},
+    {Parameter::FORCE, "force", 0.0, 1, 1000, true, ParameterTable::FORCES, parameter_bit(Parameter::TIME) | parameter_bit(Parameter::MASS)},
+    {Parameter::MASS, "mass", 0.0, 1, 1000, true, ParameterTable::FORCES, parameter_bit(Parameter::FORCE) | parameter_bit(Parameter::TIME)}
+};
+
+constexpr bool parameter_info_in_enum_order(){
+    for (std::size_t i = 0; i < PARAMETER_COUNT; i++){
+        if (static_cast<std::size_t>(PARAMETER_INFO[i].parameter) != i)
+            return false;
+    }
+    return true;
+}
+static_assert(parameter_info_in_enum_order(), "PARAMETER_INFO must list the parameters in the order of the Parameter enum");
+
+constexpr const ParameterInfo &parameter_info(Parameter parameter) { return PARAMETER_INFO[static_cast<std::size_t>(parameter)]; }
+
+// Current value of every parameter, indexed by Parameter; 0 means "not given" for every parameter but the angle
+struct ParameterValues{
+    double value[PARAMETER_COUNT] {};
+
+    ParameterValues() { reset(); }
+
+    double &operator[](Parameter parameter) { return value[static_cast<std::size_t>(parameter)]; }
+    const double &operator[](Parameter parameter) const { return value[static_cast<std::size_t>(parameter)]; }
+
+    // Puts every parameter back to its default value
+    void reset(){
+        for (std::size_t i = 0; i < PARAMETER_COUNT; i++)
+            value[i] = PARAMETER_INFO[i].default_value;
+    }
+};
+
+// Result of the physics engine, anything but SOLVED leaves the unknowns unsolved
+// NOT_CONVERGED: a launch from a height that no launch matches (or that the iteration could not find)
+enum class SolveStatus {SOLVED, UNSUPPORTED_KNOWN_SET, NOT_CONVERGED};
+
+struct HeightSolveReport;
+
+// Physics Engine
+// Launches from a height go through solve_launch_from_height(), which also solves the angle when three other
+// quantities are known; report (optional) receives how that went
+SolveStatus find_unknown(double &y_initial, double &v_initial, double &v_final, double &acc, double &time, double &max_height, double &abs_max_height, double &range, double &angle, double &v_initial_i_component, double &v_initial_j_component, double &v_final_i_component, double &v_final_j_component, double &apexTime, HeightSolveReport *report = nullptr);
+
+// Why an input table was rejected, format_input_error() turns it into a message
+enum class InputError {NONE, OUT_OF_RANGE, MISSING_DEPENDENCY, NOT_ENOUGH_INPUTS, SPEED_MISMATCH, I_COMPONENT_MISMATCH, J_COMPONENT_MISMATCH,
+                       NOT_CONVERGED, UNSUPPORTED_KNOWN_SET, INCONSISTENT_VALUES, NOT_SOLVED, MISSING_FORCE_INPUT, INVALID_DRAG};
+
+// Outcome of validating (and solving) an input table, small enough to be returned by value
+// Only the fields that belong to the error are set
+struct InputCheck{
+    InputError error {InputError::NONE};
+    Parameter parameter {};                    // OUT_OF_RANGE, MISSING_DEPENDENCY, MISSING_FORCE_INPUT: the offending parameter
+    Parameter dependency {};                   // MISSING_DEPENDENCY: the dependency that was not given
+    double value {};                           // OUT_OF_RANGE: the rejected value
+    unsigned int scalar_count {}, vector_count {}; // NOT_ENOUGH_INPUTS: required inputs that were given
+
+    bool ok() const { return error == InputError::NONE; }
+};
+
+// Parameters holding a value (anything but 0)
+ParameterMask given_parameters(const ParameterValues &parameters);
+
+// Verifies all input fields of the table without solving it, never allocates
+InputCheck check_input(const ParameterValues &parameters);
+
+// Verifies all input fields of the table and runs the physics engine on them, never allocates
+InputCheck cleanup_input(ParameterValues &parameters);
+
+// Launches from the ground land as fast as they start: when both speeds are given in base and parameters changed
+// only one of them, the other one is set to match
+void follow_launch_speed(const ParameterValues &base, ParameterValues &parameters);
+
+// Writes the message of a check into buffer (always null terminated), returns the length of the full message
+// Formatting is kept apart from checking so messages are only built when they are shown
+std::size_t format_input_error(const InputCheck &check, char *buffer, std::size_t size);
+std::string format_input_error(const InputCheck &check);
@@ -0,0 +1,505 @@
+// Headless solver daemon
+// Listens on a Unix domain socket for solver requests (wire format in solver_protocol.hpp) and answers every
+// client from one epoll event loop. Requests that arrive within a short window are coalesced into one batch and
+// solved together by cleanup_input_batch() on a thread of their own, so the loop keeps reading and writing while
+// a batch is solved; the next batch collects in the meantime, which makes batches grow with the load.
+// Sockets are non-blocking: replies that do not fit into the socket buffer wait for EPOLLOUT.
+// A client that shuts down its sending side still gets the replies to every request it sent before it is closed.
+#include "batch_solver.hpp"
+#include "kinematics_core.hpp"
+#include "slot_map.hpp"
+#include "solver_protocol.hpp"
+#include "spsc_queue.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Constant config values
+const char *DEFAULT_SOCKET_PATH {"/tmp/kinematics_solver.sock"};
+const long DEFAULT_WINDOW_US {0};
+const std::size_t DEFAULT_MAX_BATCH {4096};
+const std::size_t TABLES_PER_TASK {512};
+const std::size_t READ_CHUNK {65536};
+const int MAX_EVENTS {256};
+
+// epoll tags of the file descriptors that are not clients, clients are tagged with their slot handle
+const std::uint64_t LISTEN_TAG {~0ull}, SOLVED_TAG {~0ull - 1}, WINDOW_TAG {~0ull - 2};
+
+struct DaemonOptions{
+    std::string socket_path {DEFAULT_SOCKET_PATH};
+    long window_us {DEFAULT_WINDOW_US};
+    std::size_t max_batch {DEFAULT_MAX_BATCH};
+    unsigned int thread_count {1};
+};
+
+void print_usage(){
+    std::cerr << "Usage: kinematics_daemon [-s socket] [-w window_us] [-b max_batch] [-j threads]\n"
+                 "  -s socket     Unix domain socket to listen on (default " << DEFAULT_SOCKET_PATH << ")\n"
+                 "  -w window_us  how long the first request of a batch waits for others, 0 only batches what arrives while\n"
+                 "                the previous batch is solved (default " << DEFAULT_WINDOW_US << ")\n"
+                 "  -b max_batch  requests that end the window early (default " << DEFAULT_MAX_BATCH << ")\n"
+                 "  -j threads    threads solving a batch, 0 uses every hardware thread (default 1)\n";
+}
+
+bool parse_options(int argc, char **argv, DaemonOptions &options){
+    for (int i = 1; i < argc; i++){
+        const std::string arg = argv[i];
+        if ((arg == "-s" || arg == "-w" || arg == "-b" || arg == "-j") && i + 1 < argc){
+            const std::string value = argv[++i];
+            if (arg == "-s")
+                options.socket_path = value;
+            else if (arg == "-w")
+                options.window_us = std::max(0L, std::strtol(value.c_str(), nullptr, 10));
+            else if (arg == "-b")
+                options.max_batch = std::max<std::size_t>(1, std::strtoull(value.c_str(), nullptr, 10));
+            else
+                options.thread_count = static_cast<unsigned int>(std::strtoul(value.c_str(), nullptr, 10));
+        }
+        else
+            return false;
+    }
+    return !options.socket_path.empty();
+}
+
+// Requests of one batch, by index: whom to answer, the tables to solve and their checks
+struct solve_batch{
+    std::vector<slot_handle> clients {};
+    std::vector<std::uint32_t> ids {};
+    std::vector<ParameterValues> tables {};
+    std::vector<InputCheck> checks {};
+
+    std::size_t size() const { return ids.size(); }
+    void clear(){
+        clients.clear();
+        ids.clear();
+        tables.clear();
+    }
+};
+
+// Thread that solves batches handed over by the event loop and wakes the loop through an eventfd when one is done
+// Only one batch is ever in flight, so both queues can stay small
+class batch_solver_thread{
+    private:
+        static constexpr std::size_t QUEUE_CAPACITY {4};
+
+        spsc_queue<solve_batch *, QUEUE_CAPACITY> requests {}; // Loop -> solver
+        spsc_queue<solve_batch *, QUEUE_CAPACITY> results {};  // Solver -> loop
+        const int done_fd;
+        thread_pool pool;
+        std::atomic<bool> stopping {false};
+        std::mutex sleep_mutex {};
+        std::condition_variable wake {};
+        std::thread worker {};
+
+        void solve(solve_batch &batch){
+            batch.checks.resize(batch.size());
+            pool.parallel_for(batch.size(), TABLES_PER_TASK, [&](std::size_t begin, std::size_t end){
+                thread_local ScenarioBatch scratch {};
+                cleanup_input_batch(batch.tables.data() + begin, batch.checks.data() + begin, end - begin, scratch);
+            });
+        }
+
+        void worker_loop(){
+            solve_batch *batch {};
+            while (true){
+                {
+                    std::unique_lock<std::mutex> lock(sleep_mutex);
+                    wake.wait(lock, [&]{ return stopping.load() || !requests.empty(); });
+                }
+                if (stopping)
+                    return;
+
+                while (requests.try_pop(batch)){
+                    solve(*batch);
+                    while (!results.try_push(batch))
+                        std::this_thread::yield();
+                    const std::uint64_t one {1};
+                    if (write(done_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+                        std::cerr << "Could not wake the event loop: " << std::strerror(errno) << "\n";
+                }
+            }
+        }
+
+    public:
+        batch_solver_thread(int done_fd, unsigned int thread_count): done_fd(done_fd), pool(thread_count),
+            worker(&batch_solver_thread::worker_loop, this) {}
+
+        ~batch_solver_thread(){
+            stopping = true;
+            { std::lock_guard<std::mutex> lock(sleep_mutex); }
+            wake.notify_one();
+            worker.join();
+        }
+
+        batch_solver_thread(const batch_solver_thread &) = delete;
+        batch_solver_thread &operator=(const batch_solver_thread &) = delete;
+
+        // Loop thread: at most one batch is in flight, so this always fits
+        void submit(solve_batch *batch){
+            requests.try_push(batch);
+            { std::lock_guard<std::mutex> lock(sleep_mutex); }
+            wake.notify_one();
+        }
+
+        // Loop thread: returns false when no batch is done
+        bool collect(solve_batch *&batch) { return results.try_pop(batch); }
+
+        unsigned int threads() const { return pool.size(); }
+};
+
+struct client{
+    int fd {-1};
+    std::vector<char> input {};  // Received bytes that do not make a whole frame yet
+    std::vector<char> output {}; // Replies not yet accepted by the socket, from `sent` on
+    std::size_t sent {};
+    std::size_t queued {};         // Requests read but not answered yet
+    bool waiting_to_write {false}; // Registered for EPOLLOUT instead of EPOLLIN
+    bool half_closed {false};      // Sends no more requests, closed once every reply is written
+};
+
+// Requests while the client may send them, otherwise only replies that wait for room in the socket
+// A half-closed client is not watched for EPOLLRDHUP, which would keep firing
+std::uint32_t client_events(const client &c){
+    const std::uint32_t events = c.waiting_to_write ? EPOLLOUT : (c.half_closed ? 0u : EPOLLIN);
+    return c.half_closed ? events : events | EPOLLRDHUP;
+}
+
+// Half-closed and every reply written
+bool client_finished(const client &c){
+    return c.half_closed && c.queued == 0 && c.output.empty();
+}
+
+std::uint64_t client_tag(slot_handle handle){
+    return static_cast<std::uint64_t>(handle.index) << 32 | handle.generation;
+}
+
+slot_handle tag_client(std::uint64_t tag){
+    return {static_cast<std::uint32_t>(tag >> 32), static_cast<std::uint32_t>(tag)};
+}
+
+volatile std::sig_atomic_t stop_requested {0};
+
+void request_stop(int){
+    stop_requested = 1;
+}
+
+class solver_daemon{
+    private:
+        const DaemonOptions options;
+        int epoll_fd {-1}, listen_fd {-1}, solved_fd {-1}, window_fd {-1};
+        slot_map<client> clients {};
+        solve_batch batches[2] {}; // One collects while the other one is solved
+        solve_batch *collecting {&batches[0]}, *solving {nullptr};
+        bool window_open {false}, window_over {false};
+        std::unique_ptr<batch_solver_thread> solver {};
+
+        std::uint64_t request_count {}, batch_count {}, dropped_count {};
+        std::size_t largest_batch {};
+
+        bool watch(int fd, std::uint32_t events, std::uint64_t tag, int operation = EPOLL_CTL_ADD){
+            epoll_event event {};
+            event.events = events;
+            event.data.u64 = tag;
+            return epoll_ctl(epoll_fd, operation, fd, &event) == 0;
+        }
+
+        void set_window(long microseconds){
+            itimerspec timer {};
+            timer.it_value.tv_sec = microseconds / 1000000;
+            timer.it_value.tv_nsec = (microseconds % 1000000) * 1000;
+            timerfd_settime(window_fd, 0, &timer, nullptr);
+        }
+
+        void close_client(slot_handle handle){
+            if (client *c = clients.get(handle)){
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd, nullptr);
+                close(c->fd);
+                clients.erase(handle);
+            }
+        }
+
+        void accept_clients(){
+            while (true){
+                const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0){
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                        std::cerr << "accept failed: " << std::strerror(errno) << "\n";
+                    if (errno == EINTR)
+                        continue;
+                    return;
+                }
+                const slot_handle handle = clients.insert(client{fd});
+                if (!watch(fd, EPOLLIN | EPOLLRDHUP, client_tag(handle))){
+                    close(fd);
+                    clients.erase(handle);
+                }
+            }
+        }
+
+        // Reads whatever the client sent and queues every complete request, false once the client is gone
+        // At the end of the stream the requests read so far are still queued and the client is marked half-closed
+        bool read_client(slot_handle handle, client &c){
+            while (!c.half_closed){
+                const std::size_t at = c.input.size();
+                c.input.resize(at + READ_CHUNK);
+                const ssize_t received = read(c.fd, c.input.data() + at, READ_CHUNK);
+                c.input.resize(at + (received > 0 ? static_cast<std::size_t>(received) : 0));
+                if (received == 0){
+                    c.half_closed = true;
+                    watch(c.fd, client_events(c), client_tag(handle), EPOLL_CTL_MOD);
+                    break;
+                }
+                if (received < 0){
+                    if (errno == EINTR)
+                        continue;
+                    if (errno != EAGAIN && errno != EWOULDBLOCK)
+                        return false;
+                    break;
+                }
+            }
+
+            std::size_t offset {}, consumed {};
+            SolverRequest request {};
+            while (true){
+                const FrameStatus status = read_request(c.input.data() + offset, c.input.size() - offset, request, consumed);
+                if (status == FrameStatus::MALFORMED)
+                    return false; // Nothing after a broken frame can be trusted
+                if (status == FrameStatus::INCOMPLETE)
+                    break;
+                collecting->clients.push_back(handle);
+                collecting->ids.push_back(request.id);
+                collecting->tables.push_back(request.parameters);
+                offset += consumed;
+                c.queued++;
+                request_count++;
+            }
+            // A frame cut off by the end of the stream can never be completed
+            if (c.half_closed)
+                c.input.clear();
+            else
+                c.input.erase(c.input.begin(), c.input.begin() + static_cast<std::ptrdiff_t>(offset));
+            return true;
+        }
+
+        // Writes queued replies until the socket is full, false once the client is gone
+        // While replies wait for EPOLLOUT the client is not read, so a client that does not read can not pile up work
+        bool flush_client(slot_handle handle, client &c){
+            while (c.sent < c.output.size()){
+                const ssize_t written = send(c.fd, c.output.data() + c.sent, c.output.size() - c.sent, MSG_NOSIGNAL);
+                if (written < 0){
+                    if (errno == EINTR)
+                        continue;
+                    if (errno != EAGAIN && errno != EWOULDBLOCK)
+                        return false;
+                    break;
+                }
+                c.sent += static_cast<std::size_t>(written);
+            }
+
+            const bool pending = c.sent < c.output.size();
+            if (!pending){
+                c.output.clear();
+                c.sent = 0;
+            }
+            if (pending != c.waiting_to_write){
+                c.waiting_to_write = pending;
+                watch(c.fd, client_events(c), client_tag(handle), EPOLL_CTL_MOD);
+            }
+            return true;
+        }
+
+        // Hands the collected batch to the solver once it is idle and the window is over or the batch is full
+        void dispatch(){
+            if (solving != nullptr || collecting->size() == 0)
+                return;
+            if (!window_over && collecting->size() < options.max_batch && options.window_us > 0)
+                return;
+
+            solving = collecting;
+            collecting = solving == &batches[0] ? &batches[1] : &batches[0];
+            window_open = window_over = false;
+            set_window(0);
+            batch_count++;
+            largest_batch = std::max(largest_batch, solving->size());
+            solver->submit(solving);
+        }
+
+        // Turns a solved batch into replies, clients that left in the meantime are skipped
+        void answer(){
+            std::uint64_t wakeups {};
+            if (read(solved_fd, &wakeups, sizeof(wakeups)) < 0 && errno != EAGAIN)
+                std::cerr << "eventfd read failed: " << std::strerror(errno) << "\n";
+
+            solve_batch *batch {};
+            while (solver->collect(batch)){
+                SolverResponse response {};
+                for (std::size_t i = 0; i < batch->size(); i++){
+                    client *c = clients.get(batch->clients[i]);
+                    if (c == nullptr){
+                        dropped_count++;
+                        continue;
+                    }
+                    c->queued--;
+                    response.id = batch->ids[i];
+                    response.check = batch->checks[i];
+                    response.parameters = batch->tables[i];
+                    append_response(c->output, response);
+                }
+                // Every client of the batch gets its replies with one write, half-closed ones are closed once they are all out
+                for (std::size_t i = 0; i < batch->size(); i++){
+                    client *c = clients.get(batch->clients[i]);
+                    if (c == nullptr)
+                        continue;
+                    const bool alive = c->waiting_to_write || c->sent == c->output.size() || flush_client(batch->clients[i], *c);
+                    if (!alive || client_finished(*c))
+                        close_client(batch->clients[i]);
+                }
+                batch->clear();
+                solving = nullptr;
+            }
+        }
+
+    public:
+        explicit solver_daemon(const DaemonOptions &options): options(options) {}
+
+        ~solver_daemon(){
+            solver.reset(); // Joins the solver before the batches go away
+            for (client &c : clients)
+                close(c.fd);
+            for (int fd : {listen_fd, solved_fd, window_fd, epoll_fd}){
+                if (fd >= 0)
+                    close(fd);
+            }
+            if (listen_fd >= 0)
+                unlink(options.socket_path.c_str());
+        }
+
+        bool open(std::string &error){
+            sockaddr_un address {};
+            address.sun_family = AF_UNIX;
+            if (options.socket_path.size() >= sizeof(address.sun_path)){
+                error = "Socket path is too long: " + options.socket_path;
+                return false;
+            }
+            std::memcpy(address.sun_path, options.socket_path.c_str(), options.socket_path.size() + 1);
+            unlink(options.socket_path.c_str()); // A socket left behind by a daemon that did not shut down
+
+            epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            solved_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            window_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (epoll_fd < 0 || listen_fd < 0 || solved_fd < 0 || window_fd < 0){
+                error = std::string("Could not create the event loop: ") + std::strerror(errno);
+                return false;
+            }
+            if (bind(listen_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || listen(listen_fd, SOMAXCONN) != 0){
+                error = "Could not listen on " + options.socket_path + ": " + std::strerror(errno);
+                return false;
+            }
+            if (!watch(listen_fd, EPOLLIN, LISTEN_TAG) || !watch(solved_fd, EPOLLIN, SOLVED_TAG) || !watch(window_fd, EPOLLIN, WINDOW_TAG)){
+                error = std::string("Could not watch the sockets: ") + std::strerror(errno);
+                return false;
+            }
+            solver = std::make_unique<batch_solver_thread>(solved_fd, options.thread_count);
+            return true;
+        }
+
+        // Runs until SIGINT or SIGTERM
+        void run(){
+            epoll_event events[MAX_EVENTS];
+            while (!stop_requested){
+                const int count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+                if (count < 0){
+                    if (errno == EINTR)
+                        continue;
+                    std::cerr << "epoll_wait failed: " << std::strerror(errno) << "\n";
+                    return;
+                }
+
+                for (int i = 0; i < count; i++){
+                    const std::uint64_t tag = events[i].data.u64;
+                    if (tag == LISTEN_TAG)
+                        accept_clients();
+                    else if (tag == SOLVED_TAG)
+                        answer();
+                    else if (tag == WINDOW_TAG){
+                        std::uint64_t expirations {};
+                        if (read(window_fd, &expirations, sizeof(expirations)) > 0)
+                            window_over = true;
+                    }
+                    else{
+                        const slot_handle handle = tag_client(tag);
+                        client *c = clients.get(handle);
+                        if (c == nullptr)
+                            continue; // Closed earlier in this round
+                        bool alive {true};
+                        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                            alive = read_client(handle, *c);
+                        if (alive && (events[i].events & EPOLLOUT))
+                            alive = flush_client(handle, *c);
+                        // EPOLLHUP: the client can not read either, so its replies have nowhere to go
+                        if (!alive || (events[i].events & (EPOLLHUP | EPOLLERR)) || client_finished(*c))
+                            close_client(handle);
+                    }
+                }
+
+                // The window starts with the first request of a batch
+                if (collecting->size() > 0 && !window_open && options.window_us > 0){
+                    window_open = true;
+                    set_window(options.window_us);
+                }
+                dispatch();
+            }
+        }
+
+        void print_stats() const {
+            std::cerr << request_count << " requests in " << batch_count << " batches (" << (batch_count > 0 ? static_cast<double>(request_count) / batch_count : 0.0)
+                      << " per batch, at most " << largest_batch << "), " << dropped_count << " replies to closed clients dropped\n";
+        }
+
+        unsigned int threads() const { return solver->threads(); }
+};
+
+int main(int argc, char **argv){
+    DaemonOptions options {};
+    if (!parse_options(argc, argv, options)){
+        print_usage();
+        return 2;
+    }
+
+    struct sigaction action {};
+    action.sa_handler = request_stop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    solver_daemon daemon {options};
+    std::string error {};
+    if (!daemon.open(error)){
+        std::cerr << error << "\n";
+        return 1;
+    }
+    std::cerr << "Listening on " << options.socket_path << ", window " << options.window_us << " us, batches of up to "
+              << options.max_batch << " solved on " << daemon.threads() << " threads\n";
+    daemon.run();
+    daemon.print_stats();
+    return 0;
+}
@@ -0,0 +1,242 @@
+// Load generator for kinematics_daemon
+// Opens a number of connections, keeps a fixed number of requests in flight on each and reports the throughput
+// and the latency distribution of the replies. With -v every reply is checked against cleanup_input() run locally.
+#include "counter_rng.hpp"
+#include "kinematics_core.hpp"
+#include "solver_protocol.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Constant config values
+const char *DEFAULT_SOCKET_PATH {"/tmp/kinematics_solver.sock"};
+const std::size_t READ_CHUNK {65536};
+const int MAX_EVENTS {256};
+
+struct LoadOptions{
+    std::string socket_path {DEFAULT_SOCKET_PATH};
+    std::size_t connections {32}, requests {100000}, depth {4};
+    std::uint64_t seed {1};
+    bool verify {false};
+};
+
+void print_usage(){
+    std::cerr << "Usage: kinematics_load [-s socket] [-c connections] [-n requests] [-d depth] [-r seed] [-v]\n"
+                 "  -s socket       daemon socket (default " << DEFAULT_SOCKET_PATH << ")\n"
+                 "  -c connections  concurrent connections (default 32)\n"
+                 "  -n requests     requests sent in total (default 100000)\n"
+                 "  -d depth        requests in flight per connection (default 4)\n"
+                 "  -r seed         seed of the random scenarios (default 1)\n"
+                 "  -v              check every reply against the local solver\n";
+}
+
+bool parse_options(int argc, char **argv, LoadOptions &options){
+    for (int i = 1; i < argc; i++){
+        const std::string arg = argv[i];
+        if (arg == "-v")
+            options.verify = true;
+        else if ((arg == "-s" || arg == "-c" || arg == "-n" || arg == "-d" || arg == "-r") && i + 1 < argc){
+            const std::string value = argv[++i];
+            if (arg == "-s")
+                options.socket_path = value;
+            else if (arg == "-c")
+                options.connections = std::max<std::size_t>(1, std::strtoull(value.c_str(), nullptr, 10));
+            else if (arg == "-n")
+                options.requests = std::strtoull(value.c_str(), nullptr, 10);
+            else if (arg == "-d")
+                options.depth = std::max<std::size_t>(1, std::strtoull(value.c_str(), nullptr, 10));
+            else
+                options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else
+            return false;
+    }
+    // Request ids are 32 bits wide
+    return options.requests <= UINT32_MAX;
+}
+
+// Random scenario number index from one of the known sets the simulator offers; some are out of range or inconsistent
+ParameterValues random_scenario(std::uint64_t seed, std::uint64_t index){
+    auto draw = [&](std::uint32_t stream, double low, double high){
+        return low + (high - low) * counter_rng{seed, index, stream}.uniform();
+    };
+    ParameterValues parameters {};
+    parameters[Parameter::ACC] = draw(0, -20, -1);
+    switch (static_cast<int>(draw(1, 0, 3))){
+        case 0:
+            parameters[Parameter::INITIAL_SPEED] = draw(2, 0.5, 60);
+            parameters[Parameter::TIME] = draw(3, 1, 10);
+            break;
+        case 1:
+            parameters[Parameter::V_INITIAL_I_COMPONENT] = draw(2, 0.5, 50);
+            parameters[Parameter::V_INITIAL_J_COMPONENT] = draw(3, 0.5, 50);
+            break;
+        default:
+            parameters[Parameter::INITIAL_SPEED] = draw(2, 1, 60);
+            parameters[Parameter::ANGLE] = draw(3, 1, 89);
+            parameters[Parameter::Y_INITIAL] = draw(4, 0, 50);
+            break;
+    }
+    return parameters;
+}
+
+// Same result within rounding, the daemon may have solved the table with a vector kernel
+bool same_values(double a, double b){
+    if (std::isnan(a) || std::isnan(b))
+        return std::isnan(a) && std::isnan(b);
+    return std::abs(a - b) <= 1e-9 * std::max({1.0, std::abs(a), std::abs(b)});
+}
+
+bool same_result(const SolverResponse &response, const ParameterValues &sent){
+    ParameterValues expected = sent;
+    const InputCheck check = cleanup_input(expected);
+    if (check.error != response.check.error)
+        return false;
+    if (!check.ok())
+        return true; // Which table comes back with an error does not matter
+    for (std::size_t i = 0; i < PARAMETER_COUNT; i++){
+        if (!same_values(expected.value[i], response.parameters.value[i]))
+            return false;
+    }
+    return true;
+}
+
+struct connection{
+    int fd {-1};
+    std::vector<char> input {};
+    std::size_t in_flight {};
+};
+
+using load_clock = std::chrono::steady_clock;
+
+int main(int argc, char **argv){
+    LoadOptions options {};
+    if (!parse_options(argc, argv, options)){
+        print_usage();
+        return 2;
+    }
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (options.socket_path.size() >= sizeof(address.sun_path)){
+        std::cerr << "Socket path is too long: " << options.socket_path << "\n";
+        return 1;
+    }
+    std::memcpy(address.sun_path, options.socket_path.c_str(), options.socket_path.size() + 1);
+
+    const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<connection> connections(options.connections);
+    for (std::size_t i = 0; i < connections.size(); i++){
+        connection &c = connections[i];
+        c.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (c.fd < 0 || connect(c.fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0){
+            std::cerr << "Could not connect to " << options.socket_path << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, c.fd, &event);
+    }
+
+    // Sends are blocking: at most depth requests are in flight per connection, far less than a socket buffer
+    std::vector<load_clock::time_point> sent_at(options.requests);
+    std::vector<double> latencies {};
+    latencies.reserve(options.requests);
+    std::vector<char> frame {};
+    std::uint64_t next_request {}, mismatches {}, rejected {};
+    auto send_requests = [&](connection &c){
+        frame.clear();
+        while (c.in_flight < options.depth && next_request < options.requests){
+            append_request(frame, static_cast<std::uint32_t>(next_request), random_scenario(options.seed, next_request));
+            sent_at[next_request++] = load_clock::now();
+            c.in_flight++;
+        }
+        for (std::size_t sent = 0; sent < frame.size();){
+            const ssize_t written = send(c.fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno != EINTR)
+                return false;
+            sent += written > 0 ? static_cast<std::size_t>(written) : 0;
+        }
+        return true;
+    };
+
+    const load_clock::time_point start = load_clock::now();
+    for (connection &c : connections){
+        if (!send_requests(c)){
+            std::cerr << "Could not send: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+    }
+
+    epoll_event events[MAX_EVENTS];
+    SolverResponse response {};
+    while (latencies.size() < options.requests){
+        const int count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (count < 0 && errno != EINTR){
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        for (int i = 0; i < count; i++){
+            connection &c = connections[events[i].data.u64];
+            const std::size_t at = c.input.size();
+            c.input.resize(at + READ_CHUNK);
+            const ssize_t received = read(c.fd, c.input.data() + at, READ_CHUNK);
+            if (received <= 0){
+                std::cerr << "The daemon closed the connection\n";
+                return 1;
+            }
+            c.input.resize(at + static_cast<std::size_t>(received));
+
+            const load_clock::time_point now = load_clock::now();
+            std::size_t offset {}, consumed {};
+            while (true){
+                const FrameStatus status = read_response(c.input.data() + offset, c.input.size() - offset, response, consumed);
+                if (status == FrameStatus::MALFORMED || (status == FrameStatus::COMPLETE && response.id >= options.requests)){
+                    std::cerr << "Malformed reply from the daemon\n";
+                    return 1;
+                }
+                if (status == FrameStatus::INCOMPLETE)
+                    break;
+                offset += consumed;
+                c.in_flight--;
+                latencies.push_back(std::chrono::duration<double, std::micro>(now - sent_at[response.id]).count());
+                rejected += !response.check.ok();
+                if (options.verify && !same_result(response, random_scenario(options.seed, response.id)))
+                    mismatches++;
+            }
+            c.input.erase(c.input.begin(), c.input.begin() + static_cast<std::ptrdiff_t>(offset));
+            if (!send_requests(c)){
+                std::cerr << "Could not send: " << std::strerror(errno) << "\n";
+                return 1;
+            }
+        }
+    }
+    const double seconds = std::chrono::duration<double>(load_clock::now() - start).count();
+    for (connection &c : connections)
+        close(c.fd);
+    close(epoll_fd);
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double fraction){
+        return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(fraction * latencies.size()))];
+    };
+    std::cout << options.requests << " requests (" << rejected << " rejected) over " << options.connections << " connections, depth "
+              << options.depth << ": " << (seconds > 0 ? options.requests / seconds : 0.0) << " requests/second\n"
+              << "latency us: p50 " << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 " << percentile(0.99)
+              << ", p99.9 " << percentile(0.999) << ", max " << (latencies.empty() ? 0.0 : latencies.back()) << "\n";
+    if (options.verify)
+        std::cout << mismatches << " replies differ from the local solver\n";
+    return mismatches == 0 ? 0 : 1;
+}
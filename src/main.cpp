@@ -3,26 +3,100 @@
 #include <SFML/Window/Keyboard.hpp>
 #include <imgui.h>
 #include <imgui-SFML.h>
+#include "chunked_batch.hpp"
+#include "collision.hpp"
+#include "columnar_export.hpp"
+#include "forces.hpp"
+#include "kinematics_core.hpp"
+#include "monte_carlo.hpp"
+#include "parameter_sweep.hpp"
+#include "scale_stripes.hpp"
+#include "solve_worker.hpp"
+#include "shape_batch.hpp"
+#include "slot_map.hpp"
+#include "targeting.hpp"
+#include "trail.hpp"
+#include "trajectory.hpp"
+#include "volley.hpp"
+#include "volley_batch.hpp"
 #include <vector>
 #include <cmath>
-#include <memory>
 #include <string>
-#include <map>
 #include <algorithm>
+#include <variant>
+#include <future>
 
 // GLOBAL VALUES
 // Constant config values
 const unsigned int FPS_LOCK {60}, WIDTH {1280}, HEIGHT {720};
 const double CAMERA_SPEED {2.0}, TIME_INTERVAL{0.1};
+const double STEP_SECONDS {1.0 / 60}; // Real time per simulation step of TIME_INTERVAL, independent of the frame rate
+const int DEFAULT_TABLE_SAMPLES {1000}, MAX_TABLE_SAMPLES {100000000}; // Evenly spaced rows of the Trajectory Data table and its export
+const double DEFAULT_SAMPLE_TOLERANCE {0.25}, MIN_SAMPLE_TOLERANCE {1e-6}; // Largest distance (m) of the trail and the adaptive rows from the path
+const int SETTLE_FRAMES {3}; // Frames drawn after the last event before going idle, ImGui needs a few to settle hover and focus
+const sf::Time IDLE_WAIT {sf::milliseconds(250)}; // Longest sleep while idle
+const int MAX_SWEEP_STEPS {2000}; // Cells along one axis of a parameter sweep
+const float SWEEP_IMAGE_SIZE {300.f};
+const int MAX_MONTE_CARLO_SAMPLES {100000000};
+const int TARGET_ARC_SEGMENTS {32}; // Line segments per drawn launch arc
+const std::size_t RANDOM_TARGETS {1000}; // Targets added at once by "Scatter"
+const float TARGET_MARKER_SIZE {6.f};
+const int MAX_FORCE_BATCH_BODIES {100000};
+const int MAX_VOLLEY_PROJECTILES {1000000}; // Live projectiles of all volleys together
+const std::size_t RANDOM_OBSTACLES {1000}; // Obstacles added at once by "Scatter"
+const float ZOOM_STEP {1.25f}, MIN_ZOOM {0.25f}, MAX_ZOOM {512.f}; // Zoom is world units per pixel
+const float FOLLOW_MARGIN {0.2f}; // Part of the view on each side the projectile may not enter while the camera follows it
+const float STRIPE_WIDTH {100.f};
 
 // GLOBAL VARIABLES
-bool stop_time {true}, is_solved {false}, follow_projectile {false};
-std::string user_error_message {};
+bool stop_time {true}, is_solved {false}, follow_projectile {true};
+
+// Cost of the last frame, shown in the GUI
+struct FrameStats{
+    unsigned int draw_calls {};
+    std::size_t chunks_drawn {}; // Chunks of static shapes inside the view
+    float frame_ms {};
+};
+FrameStats frame_stats {};
+InputCheck input_check {}; // Result of the last validation, formatted only while it is shown
 
 // Main rendering surface 
 sf::RenderWindow *window = nullptr;
 // Camera object - perspective of the user
 sf::View camera(sf::FloatRect({0, 0}, {WIDTH, HEIGHT}));
+float camera_zoom {1};
+
+// Part of the world the camera shows
+sf::FloatRect camera_rect(){
+    const sf::Vector2f size = camera.getSize();
+    return {camera.getCenter() - size / 2.f, size};
+}
+
+// Centers the camera on (x, y) without showing anything left of the launch area or below the ground
+void place_camera(float x, float y){
+    const float ground = static_cast<float>(window->getSize().y);
+    const sf::Vector2f half = camera.getSize() / 2.f;
+    camera.setCenter({std::max(x, half.x), std::min(y, ground - half.y)});
+}
+
+// Scales the view around its center, factor > 1 zooms out
+void zoom_camera(float factor){
+    camera_zoom = std::clamp(camera_zoom * factor, MIN_ZOOM, MAX_ZOOM);
+    const sf::Vector2u pixels = window->getSize();
+    camera.setSize({pixels.x * camera_zoom, pixels.y * camera_zoom});
+    place_camera(camera.getCenter().x, camera.getCenter().y);
+}
+
+// Back to the view of the launch at the original scale
+void reset_camera(){
+    const sf::Vector2u pixels = window->getSize();
+    camera_zoom = 1;
+    camera.setSize({static_cast<float>(pixels.x), static_cast<float>(pixels.y)});
+    camera.setCenter({pixels.x / 2.f, pixels.y / 2.f});
+}
+
+// Scale stripes behind everything, as far as the longest range
+scale_stripes background_stripes {STRIPE_WIDTH, static_cast<float>(parameter_info(Parameter::RANGE).max) * STRIPE_WIDTH, sf::Color(43, 81, 134)};
 
 // 2D Vector
 struct Vector2 {
@@ -33,504 +107,988 @@ struct Vector2 {
     Vector2(int i, int j): x(static_cast<double>(i)), y(static_cast<double>(j)) {}
 };
 
-// Enums to store parameter name and table
-enum class Parameter{V_INITIAL_I_COMPONENT, V_INITIAL_J_COMPONENT, V_FINAL_I_COMPONENT, V_FINAL_J_COMPONENT, Y_INITIAL, ACC, ANGLE, TIME, RANGE, ABS_MAX_HEIGHT, MAX_HEIGHT, TIME_OF_APEX, INITIAL_SPEED, FINAL_SPEED, COEFF_FRICTION, FORCE, MASS};
-enum class ParameterTable {KINEMATICS_SCALAR, KINEMATICS_VECTOR, FORCES, BOTH}; // Both is kinematic and scalar 
-
-// Holds the value and corresponding metadata about the parameter
-struct ParameterInfo{
-    std::string name {};
-
-    double value {};
-    const double default_value {};
-    const int min {}, max {};
-    
-    const bool is_required {};
-    ParameterTable info_type {};
-    std::vector<Parameter> dependencies {};
-};
+// Table to store user input and values to be displayed to the user
+ParameterValues projectile_parameters {};
+
+// Validates and solves the GUI scenario off the render thread
+solve_worker gui_solver {};
+ParameterValues submitted_parameters {}; // Snapshot handed to gui_solver by the last CALCULATE
 
-// Map to store user input and values to be displayed to the user
-std::map<Parameter, ParameterInfo> projectile_parameters {
-    {Parameter::V_INITIAL_I_COMPONENT, ParameterInfo{"v_initial_i_component", 0.f, 0.f, 1, 1000, true, ParameterTable::KINEMATICS_VECTOR, {Parameter::V_INITIAL_J_COMPONENT}}},
-    {Parameter::V_INITIAL_J_COMPONENT, ParameterInfo{"v_ininitial_j_component", 0.f, 0.f, 1, 1000, true, ParameterTable::KINEMATICS_VECTOR, {Parameter::V_INITIAL_I_COMPONENT}}},
-    {Parameter::V_FINAL_I_COMPONENT, ParameterInfo{"v_final_i_component", 0.f, 0.f, 1, 1000, true, ParameterTable::KINEMATICS_VECTOR, {Parameter::V_FINAL_J_COMPONENT}}},
-    {Parameter::V_FINAL_J_COMPONENT, ParameterInfo{"v_final_j_component", 0.f, 0.f, 1, 1000, true, ParameterTable::KINEMATICS_VECTOR, {Parameter::V_FINAL_I_COMPONENT}}},
-    {Parameter::INITIAL_SPEED, ParameterInfo{"initial_speed", 0.f, 0.f, 1, 1000, true, ParameterTable::KINEMATICS_SCALAR, {}}},
-    {Parameter::FINAL_SPEED, ParameterInfo{"final_speed", 0.f, 0.f, 1, 1000, true, ParameterTable::KINEMATICS_SCALAR, {}}},
-    {Parameter::Y_INITIAL, ParameterInfo{"y_initial", 0.f, 0.f, 0, 1000, false, ParameterTable::BOTH, {}}},
-    {Parameter::COEFF_FRICTION, ParameterInfo{"coeff_friction", 0.f, 0.f, 1, 1, true, ParameterTable::FORCES, {Parameter::FORCE, Parameter::TIME, Parameter::MASS}}},
-    {Parameter::ACC, ParameterInfo{"acc", 0.f, 0.f, -1000, -1, true, ParameterTable::BOTH, {}}},
-    {Parameter::FORCE, ParameterInfo{"force", 0.f, 0.f, 1, 1000, true, ParameterTable::FORCES, {Parameter::TIME, Parameter::MASS}}},
-    {Parameter::ANGLE, ParameterInfo{"angle", 45.f, 45.f, 0, 90, false, ParameterTable::BOTH, {}}},
-    {Parameter::TIME, ParameterInfo{"time", 0.f, 0.f, 1, 1000, true, ParameterTable::BOTH, {}}},
-    {Parameter::MASS, ParameterInfo{"mass", 0.f, 0.f, 1, 1000, true, ParameterTable::FORCES, {Parameter::FORCE, Parameter::TIME}}},
-    {Parameter::RANGE, ParameterInfo{"range", 0.f, 0.f, 1, 1000, true, ParameterTable::BOTH, {}}},
-    {Parameter::MAX_HEIGHT, ParameterInfo{"max_height", 0.f, 0.f, 1, 1000, true, ParameterTable::BOTH, {}}},
-    {Parameter::ABS_MAX_HEIGHT, ParameterInfo{"abs_max_height", 0.f, 0.f, 1, 1000, false, ParameterTable::BOTH, {}}},
-    {Parameter::TIME_OF_APEX, ParameterInfo{"apexTime", 0.f, 0.f, 1, 1000, false, ParameterTable::BOTH, {}}}
+// Trajectory exports run off the render thread, the future holds the message shown once it is done
+std::future<std::string> running_export {};
+std::string export_status {};
+
+// Parameter sweep over one or two parameters of the input table, solved on a thread pool off the render thread
+struct SweepSettings{
+    int x_parameter {static_cast<int>(Parameter::ANGLE)}, y_parameter {static_cast<int>(Parameter::INITIAL_SPEED)};
+    bool sweep_y {true};
+    double x_from {0}, x_to {90}, y_from {1}, y_to {1000};
+    int x_steps {1000}, y_steps {1000};
+    int objective {static_cast<int>(Parameter::RANGE)};
+};
+SweepSettings sweep_settings {};
+std::future<SweepResult> running_sweep {};
+SweepResult sweep_result {};
+ParameterValues sweep_base {};     // Input table of the shown result
+SweepAxis sweep_x {}, sweep_y {}; // Axes of the shown result
+Parameter sweep_objective {Parameter::RANGE};
+sf::Clock sweep_clock {};         // Started with the sweep, read once it is done
+float sweep_ms {};
+sf::Texture sweep_texture {};
+
+// Monte Carlo run over the measurement uncertainty of the inputs, also solved off the render thread
+InputDistributions input_distributions {};
+MonteCarloSettings monte_carlo_settings {};
+std::future<MonteCarloResult> running_monte_carlo {};
+MonteCarloResult monte_carlo_result {};
+std::vector<float> monte_carlo_histograms[MONTE_CARLO_OUTPUT_COUNT] {}; // Copies of the histograms for ImGui
+float monte_carlo_histogram_peaks[MONTE_CARLO_OUTPUT_COUNT] {};        // Largest bin of every histogram, the top of its plot
+sf::Clock monte_carlo_clock {};
+float monte_carlo_ms {};
+
+// Inverse targeting: points placed in the scene and every launch arc that goes through them
+// Solving is cheap enough to redo on the render thread whenever the targets or the constraint change
+TargetingProblem targeting_problem {TargetConstraint::FIXED_SPEED, 80, 45};
+TargetBatch targets {};
+double new_target[2] {300, 100};
+std::size_t targets_refined {}, targets_reached {};
+float targeting_ms {};
+sf::VertexArray target_arcs {sf::PrimitiveType::Lines}; // Markers and arcs, drawn in one call
+
+// Forces tab: the body of the table is integrated on the render thread when CALCULATE is pressed and played back
+// like a solved launch; a batch of the same body with spread launches shows what the batched integrator costs, it
+// runs off the render thread and keeps no trajectories
+BodyKind force_body_kind {BodyKind::BLOCK};
+double force_drag[2] {}; // Linear and quadratic coefficients
+ForceRun force_run {};   // Counts of the last integration, its trajectory went to the projectile
+bool force_integrated {false};
+float force_ms {};
+
+struct ForceBatchStats{
+    std::size_t bodies {}, accepted_steps {}, rejected_steps {}, most_steps {};
+    double seconds {}, most_seconds {};
 };
+int force_batch_bodies {1000};
+std::future<ForceBatchStats> running_force_batch {};
+ForceBatchStats force_batch_stats {};
+
+// Volleys: many projectiles in flight at once, stepped in parallel chunks and drawn with one call
+struct VolleySettings{
+    int kind {0}; // 0: angle fan, 1: cloud
+    int count {10000};
+    VolleyLaunch launch {};
+    double angle_from {5}, angle_to {85};    // Fan
+    double speed_sigma {2}, angle_sigma {2}; // Cloud
+    int seed {1};
+};
+VolleySettings volley_settings {};
+volley volley_projectiles {};
+volley_batch volley_markers {};
+thread_pool volley_pool {};
+fixed_step_clock volley_stepper {STEP_SECONDS};
+bool volley_flying {false}, volley_moved {false};
+float volley_step_ms {}, volley_place_ms {};
+
+// Obstacles: boxes in the scene that stop the projectile and volleys, in the frame of the launch point (y up from
+// the bottom of the window); the grid is rebuilt whenever the list changes
+std::vector<Obstacle> obstacle_boxes {};
+std::vector<slot_handle> obstacle_shapes {};
+obstacle_grid scene_obstacles {};
+double new_obstacle[4] {400, 0, 40, 120}; // x, y, width, height
+float obstacle_build_ms {};
+
+// Sends the GUI scenario to the solve worker, collect_solution() picks up the result on a later frame
+void cleanup_input(){
+    submitted_parameters = projectile_parameters;
+    gui_solver.submit(submitted_parameters);
+    input_check = {};
+    is_solved = false;
+}
 
-// Physics Engine
-void find_unknown(double &y_initial, double &v_initial, double &v_final, double &acc, double &time, double &max_height, double &abs_max_height, double &range, const double &angle, double &v_initial_i_component, double &v_initial_j_component, double &v_final_i_component, double &v_final_j_component, double &apexTime) {    
-    // y_initial  --> initial height of the projectile with respect to the ground
-    // v_initial  --> initial speed (non-vector) of projectile
-    // v_final    --> final speed (non-vector) of projectile
-    // acc        --> acceleration magnitude (non-vector) of projectile (vertical axis only)
-    // time       --> full period of motion of projectile
-    // max_height     --> Height / Vertical displacement of projectile
-    // range      --> Horizontal Distance Travalled by the Projectile
-    // angle      --> angle (degrees) with respect to the x-axis
-    // v_initial_i_component  --> initial horiztonal velocity vector component (always greater than 0)
-    // v_initial_j_component  --> initial vertical velocity vector component (either 0 or positive)
-    // v_final_i_component    --> final horizontal velocity vector component (always greater than 0)
-    // v_final_j_component    --> final vertical velocity component (either 0 or negative)
+// Static object handler
+// Shapes are stored by value in a slot map, handed out handles stay valid until the shape is deleted
+using static_shape = std::variant<sf::RectangleShape, sf::CircleShape>;
+using shape_handle = slot_handle;
 
-    double theta {}; // Launch Angle: Used for symmetrical case (y_initil = 0)
-    //double theta1 {}; // Launch Angle: Used for asymmetrical case -- initial angle (y_initial > 0)
-    //double theta2 {}; // Impact Angle: Used for asymmetrical case -- final angle (y_initial > 0)
+sf::Shape &as_shape(static_shape &shape){
+    return std::visit([](auto &concrete) -> sf::Shape & { return concrete; }, shape);
+}
 
-    // The code below is responsible for checking and calculating two unknown parameters of the projectile
-    // by using the 3 known parameters. The three known parameters may be used to calculate both of the 
-    // remaining parameters, or solving for one can be further used to solve for the other.
+class static_object_manager{
+    protected:
+        slot_map<static_shape> object_list;
 
-    if(y_initial == 0.0) { // instructions executed if projectile begins on the ground
+    private:
+        // Static shapes are drawn from world-space chunks, rebuilt only after the list changed, and only the chunks
+        // inside the camera are drawn; overlapping shapes of different chunks are drawn in no particular order
+        chunked_batch batch {};
+        bool batch_dirty {true};
 
-        // Normalizing vector inputs below
+    public:
+        static_object_manager(){}
 
-        if(v_initial_i_component != 0) { // only checking for initial i-component
-            v_initial = sqrt(pow(v_initial_i_component, 2) + pow(v_initial_j_component, 2));
+        shape_handle add_object(sf::RectangleShape square, const sf::Color &color, const Vector2 &pos){
+            square.setFillColor(color);
+            square.setPosition({pos.x, pos.y});
+            batch_dirty = true;
+            return object_list.insert(square);
+        }
 
-            theta = std :: atan(abs(v_initial_j_component / v_initial_i_component));
+        shape_handle add_object(sf::CircleShape circle, const sf::Color &color, const Vector2 &pos){
+            circle.setFillColor(color);
+            circle.setPosition({pos.x, pos.y});
+            batch_dirty = true;
+            return object_list.insert(circle);
         }
 
-        else {theta = angle * (M_PI / 180.0);}
+        // nullptr once the shape was deleted
+        sf::Shape *get_object(shape_handle shape){
+            static_shape *object = object_list.get(shape);
+            return object != nullptr ? &as_shape(*object) : nullptr;
+        }
 
-        if(v_final_i_component != 0) { // only checking for final i-component
-            v_final = sqrt(pow(v_final_i_component, 2) + pow(v_final_j_component, 2));
+        void draw(){
+            if (batch_dirty){
+                batch.clear();
+                for (static_shape &object : object_list)
+                    batch.add(as_shape(object));
+                batch.upload();
+                batch_dirty = false;
+            }
+            frame_stats.draw_calls += batch.draw(*window, camera_rect(), frame_stats.chunks_drawn);
+        }
 
-            theta = std::atan(abs(v_final_j_component / v_final_i_component));
+        // Removes the shape and invalidates the handle, deleting twice is harmless
+        void delete_object(shape_handle &shape){
+            if (object_list.erase(shape))
+                batch_dirty = true;
+            shape = {};
         }
 
-        else {theta = angle * (M_PI / 180.0);}
+        std::size_t size() const { return object_list.size(); }
+};
+// Initialize the static object renderer
+static_object_manager static_object_renderer {};
 
-        // 1. time & max_height & range (checked)
-        if(time == 0 && max_height == 0 && range == 0) {
-            time = (((0 - v_initial) * std::sin(theta)) / acc) * 2;
-            max_height = (v_initial * std::sin(theta) * (time / 2)) + (0.5 * acc * pow(time / 2, 2));
-            range = v_initial * std::cos(theta) * time;
-        }
+// Dynamic object handler
+class dynamic_object_manager: public static_object_manager{
+    public:
+        dynamic_object_manager(){}
 
-        // 2. time & acc & range (checked)
-        else if(time == 0 && acc == 0 && range == 0) {
-            acc = (0 - pow((v_initial * std::sin(theta)), 2)) / (2 * max_height);
-            time = (((0 - v_initial) * std::sin(theta)) / acc) * 2;
-            range = v_initial * std::cos(theta) * time;
+        // Dynamic objects change every frame, batching them would mean a rebuild every frame
+        void draw(){
+            for (static_shape &object : object_list)
+                window->draw(as_shape(object));
+            frame_stats.draw_calls += static_cast<unsigned int>(object_list.size());
         }
 
-        // 3. acc & v_initial & range (checked)
-        else if(acc == 0 && v_initial == 0 && range == 0) {
-            v_initial = v_final;
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
-            range = v_initial * std::cos(theta) * time;
+        void move(shape_handle obj, const Vector2 &d_pos){
+            if (sf::Shape *shape = get_object(obj))
+                shape->move({d_pos.x, d_pos.y});
         }
 
-        // 4. v_final & acc & range (checked)
-        else if(v_final == 0 && acc == 0 && range == 0) {
-            v_final = v_initial;
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
-            range = v_initial * std::cos(theta) * time;
+        void set(shape_handle obj, const Vector2 &d_pos){
+            if (sf::Shape *shape = get_object(obj))
+                shape->setPosition({d_pos.x, d_pos.y});
         }
 
-        // 5. v_final & time & range (checked)
-        else if(v_final == 0 && time == 0 && range == 0) {
-            v_final = v_initial;
-            time = ((0 - v_initial) * std::sin(theta)) / (acc / 2);
-            range = v_initial * std::cos(theta) * time;
-        }
+};
+// Initialize the dynamic object handler
+dynamic_object_manager dynamic_object_handler {};
 
-        // 6. v_inital & time & range (checked)
-        else if(v_initial == 0 && time == 0 && range == 0) {
-            v_initial = v_final;
-            time = (((0 - v_initial) * std::sin(theta)) / acc) * 2;
-            range = v_initial * std::cos(theta) * time;
-        }
+// Projectile Class
+class projectile_manager {
+    private:
+        shape_handle object_handle;
+        Trajectory launched {};   // As solved
+        Trajectory trajectory {}; // As played, ends at the first obstacle
+        ObstacleHit obstacle_hit {};
+        const double radius {30};
 
-        // 7. max_height & acc & range (checked)
-        else if(max_height == 0 && acc == 0 && range == 0) {
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
-            max_height = -pow((5 * std::sin(theta)), 2) / acc;
-            range = v_initial * std::cos(theta) * time;
-        }
+        trail_polyline trail_points {}; // Where the points of path go, the same as fixed_step_run's without a window
 
-        // 8. v_initial & range & max_height (checked)
-        else if(v_initial == 0 && range == 0 && max_height == 0) {
-            v_initial = v_final;
-            time = range / (v_initial * std::cos(theta));
-            max_height = (v_initial * std::sin(theta) * (time / 2)) + (0.5 * acc * pow((time / 2), 2));
+        // The trajectory is in metres from the launch point, 1 m is drawn as 1 px from (start_x, start_y)
+        sf::Vector2f screen_point(double time) const {
+            return {static_cast<float>(this->start_x + this->trajectory.x_at(time)),
+                    static_cast<float>(window->getSize().y - (this->start_y + this->trajectory.y_at(time)))};
         }
 
-        // 9. range & v_final & max_height (checked)
-        else if(range == 0 && v_final == 0 && max_height == 0) {
-            v_final  = v_initial;
-            range = v_initial * std::cos(theta) * time;
-            max_height = (v_initial * std::sin(theta) * (time / 2)) + (0.5 * acc * pow((time / 2), 2));
+        // Adds the path up to time to the trail
+        void extend_trail(double time){
+            this->trail_points.extend(this->trajectory, time, this->sample_tolerance, [this](double point_time, bool replaces_tip){
+                if (replaces_tip)
+                    this->path.move_last(this->screen_point(point_time));
+                else
+                    this->path.push(this->screen_point(point_time));
+            });
         }
 
-        // 10. v_final & v_initial & range ()
-        else if(v_final == 0 && v_initial == 0 && range == 0) {
-            v_initial = (max_height - 0.5 * acc * pow(time / 2, 2)) / ((time / 2) * std::sin(theta));
-            v_final = v_initial;
-            range = v_initial * std::cos(theta) * time;
+        void resample(){
+            if (this->even_samples)
+                this->samples.reset(this->trajectory, this->sample_count);
+            else
+                this->samples.reset_adaptive(this->trajectory, this->sample_tolerance);
         }
 
-        // 11. max_height & time & v_initial (checked)
-        else if(max_height == 0 && time == 0 && v_initial == 0) {
-            v_initial = v_final;
-            time = (((0 - v_initial) * std::sin(theta)) / acc) * 2;
-            max_height = (v_initial * std::sin(theta) * time) + (0.5 * acc * pow(time, 2));
-        }
+    public:
+        const Trajectory &get_trajectory() const { return this->trajectory; }
+        const ObstacleHit &get_obstacle_hit() const { return this->obstacle_hit; }
+
+        trail path {}; // Positions the projectile went through, bounded no matter how long it flies
+        playback_clock playback {};
+        fixed_step_clock stepper {STEP_SECONDS};
+        trajectory_samples samples {}; // Rows of the Trajectory Data table
+        std::size_t sample_count {DEFAULT_TABLE_SAMPLES};
+        double sample_tolerance {DEFAULT_SAMPLE_TOLERANCE};
+        bool even_samples {false}; // Table rows evenly spaced in time instead of placed where the path bends
+        const double start_x{15}, start_y{30};
+        double x, y;
 
-        // 12. max_height & time & v_final (checked)
-        else if(max_height == 0 && time == 0 && v_final == 0) {
-            v_final = v_initial;
-            time = (((0 - v_initial) * std::sin(theta) * 2) / acc) * 2;
-            max_height = (v_initial * std::sin(theta) * time) + (0.5 * acc * pow(time, 2));
+        // Normalizes coords to the bottom right of the screen
+        void normalize_coords(double &y){
+            double height = static_cast<float>(window->getSize().y);
+            y = height - y;
         }
 
-        // 13. max_height & time & acc (checked)
-        else if(max_height == 0 && time == 0 && acc == 0) {
-            time = range / (v_initial * std::cos(theta));
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
-            max_height = (v_initial * std::sin(theta) * time) + (0.5 * acc * pow(time, 2));
-        }
 
-        // 14. max_height & v_initial & v_final (checked)
-        else if(max_height == 0 && v_initial == 0 && v_final == 0) {
-            v_initial = range / (time * std::cos(theta));
-            v_final = v_initial;
-            max_height = (v_initial * std::sin(theta) * time) + (0.5 * acc * pow(time, 2));
-        }
+        projectile_manager(){
+            this-> x = this->start_x;
+            this->y = start_y;
+            normalize_coords(this->y);
 
-        // 15. max_height & v_initial & acc (checked)
-        else if(max_height == 0 && v_initial == 0 && acc == 0) {
-            v_initial = v_final;
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
-            max_height = (v_initial * std::sin(theta) * time) + (0.5 * acc * pow(time, 2));
+            this->path.push({static_cast<float>(this->x), static_cast<float>(this->y)});
+            auto circle = sf::CircleShape{this->radius};
+            circle.setOrigin({this->radius, this->radius});
+            this->object_handle = dynamic_object_handler.add_object(circle, sf::Color::Red, Vector2(this->x, this->y));
         }
 
-        // 16. max_height & v_final & acc (checked)
-        else if(max_height == 0 && v_final == 0 && acc == 0) {
-            v_final = v_initial;
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
-            max_height = (v_initial * std::sin(theta) * time) + (0.5 * acc * pow(time, 2));
-        }
+    // Loads the launch of the solved table and rewinds to its start
+    void load_trajectory(){
+        this->load_trajectory(make_trajectory(projectile_parameters));
+    }
 
-        // 17. time & v_initial & v_final (checked)
-        else if(time == 0 && v_initial == 0 && v_final == 0) {
-            time = 0;
-            v_initial = 0;
-            v_final = 0;
-        }
+    void load_trajectory(const Trajectory &loaded){
+        this->launched = loaded;
+        this->trajectory = loaded;
+        this->obstacle_hit = clip_to_obstacles(this->trajectory, scene_obstacles, this->start_x, this->start_y);
+        this->resample();
+        this->playback.reset(this->trajectory.end_time);
+        this->seek(0);
+    }
 
-        // 18. time & v_initial & acc (checked)
-        else if(time == 0 && v_initial == 0 && acc == 0) {
-            v_initial = v_final;
-            time = range / (v_initial * std::cos(theta));
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
-        }
+    // Cuts the launch again after the obstacles changed, rewinds like loading it
+    void reload(){
+        this->load_trajectory(this->launched);
+    }
+
+    // Advances playback by one fixed simulation step, stops once the projectile is back on the ground or hits an obstacle
+    void move(){
+        this->playback.step(1, TIME_INTERVAL);
+        this->place(this->playback.get_time());
+        this->extend_trail(this->playback.get_time());
+
+        if (this->playback.at_end())
+            stop_time = true;
+    }
 
-        // 19. time & v_final & acc (checked)
-        else if(time == 0 && v_final == 0 && acc == 0) {
-            v_final = v_initial;
-            time = range / (v_initial * std::cos(theta));
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
+    // Runs the steps that are due after real_seconds of wall time and draws the projectile between the last two
+    // The steps only depend on how much time passed, so any frame rate ends up with the same trajectory
+    void update(double real_seconds){
+        if (stop_time){
+            this->stepper.reset(); // No catching up on the time spent paused
+            return;
         }
 
-        // 20. v_inital & v_final & acc (checked)
-        else if(v_initial == 0 && v_final == 0 && acc == 0) {
-            v_initial = range / (time * std::cos(theta));
-            v_final = v_initial;
-            acc = ((0 - v_initial) * std::sin(theta)) / (time / 2);
+        const int steps = this->stepper.accumulate(real_seconds * this->playback.get_speed());
+        for (int i = 0; i < steps && !stop_time; i++)
+            this->move();
+
+        if (!stop_time){
+            const double render_time = std::min(this->playback.get_time() + this->stepper.alpha() * TIME_INTERVAL, this->playback.get_end());
+            this->place(render_time);
         }
     }
 
-    abs_max_height = y_initial + max_height; // Calculate maximum height (absolute) with respect to ground
-    apexTime = (-1 * v_initial * std::sin(theta)) / acc / 2; // Calculate or recalculate time the projectile needs to reach maximum height with respect to launch
-    is_solved = true;
-    user_error_message = "";
-}
+    // Resamples the table, the samples themselves are only generated once they are shown
+    void set_sample_count(std::size_t count){
+        this->sample_count = count;
+        this->resample();
+    }
 
-// Verifies all input fields
-void cleanup_input(){
-    unsigned int required_scalar_count {}, required_vector_count {};
-    std::vector<int> given {};
-    is_solved = false;
+    void set_even_samples(bool even){
+        this->even_samples = even;
+        this->resample();
+    }
 
-    // Verify all values are inside their ranges
-    for (const auto &[name, info] : projectile_parameters){
-        if (info.value == 0.0) // Ignore default values
-            continue;
+    // Resamples the table and redraws the trail for another error bound
+    void set_sample_tolerance(double tolerance){
+        this->sample_tolerance = tolerance;
+        this->resample();
+        this->seek(this->playback.get_time());
+    }
 
-        if (info.value < info.min || info.value > info.max){
-            user_error_message = "Parameter: " + info.name +
-                     " with value: " + std::to_string(info.value) +
-                     " is not within allowed range [" + std::to_string(info.min) + ", " +
-                     std::to_string(info.max) + "]\nPlease enter valid and consistent values!";
-            return;
-        }
+    // Runs every remaining step at once without drawing any of them
+    void fast_forward(){
+        stop_time = false;
+        while (!stop_time)
+            this->move();
+        this->stepper.reset();
+    }
 
-        // Cache to check for dependencies later
-        given.push_back(static_cast<int>(name));
+    // Jumps to any time of the flight, costs the same no matter how far the jump goes
+    void seek(double time){
+        this->playback.seek(time);
+        this->place(this->playback.get_time());
+
+        // The trail up to the new time is sampled again, with as many points as its bends need
+        this->path.clear();
+        this->path.push(this->screen_point(0));
+        this->trail_points.reset();
+        this->extend_trail(this->playback.get_time());
     }
 
-    // Check that all of the given variables have the required dependencies
-    for (int &index : given){
-        const ParameterInfo &info = projectile_parameters[static_cast<Parameter>(index)];
-        for (const Parameter &dep : info.dependencies) {
-            if (std::find(given.begin(), given.end(), static_cast<int>(dep)) == given.end()) {
-                user_error_message = "Missing required dependency for parameter: " + 
-                          info.name + ": dependency " +
-                          projectile_parameters[dep].name + " not provided";
-                return;
-            }
+    // Moves the projectile to where it is at `time`, does not change the playback time
+    void place(double time){
+        this->x = this->start_x + this->trajectory.x_at(time);
+        this->y = this->start_y + this->trajectory.y_at(time);
+        normalize_coords(this->y);
+        this->update_projectile();
+    }
+
+    void update_projectile(){
+        dynamic_object_handler.set(this->object_handle, Vector2(this->x, this->y));
         }
 
-        if (info.is_required) {
-            if (info.info_type == ParameterTable::KINEMATICS_SCALAR || info.info_type == ParameterTable::BOTH)
-                required_scalar_count++;
 
-            if (info.info_type == ParameterTable::KINEMATICS_VECTOR || info.info_type == ParameterTable::BOTH)
-                required_vector_count++;
+};
+
+// Takes over the result of the last CALCULATE once the worker is done with it
+void collect_solution(projectile_manager &main_projectile){
+    SolveResult result {};
+    if (!gui_solver.poll(result))
+        return;
+
+    // Inputs edited while the worker was busy make the result stale
+    if (!std::equal(std::begin(submitted_parameters.value), std::end(submitted_parameters.value), std::begin(projectile_parameters.value)))
+        return;
+
+    projectile_parameters = result.parameters;
+    input_check = result.check;
+    is_solved = input_check.ok();
+    main_projectile.load_trajectory();
+}
+
+// Writes the samples of the table to a file in the working directory
+void start_export(const projectile_manager &main_projectile, ExportFormat format){
+    if (running_export.valid())
+        return; // One export at a time
+
+    const std::string path = format == ExportFormat::BINARY ? "trajectory.kbin" : "trajectory.csv";
+    running_export = std::async(std::launch::async, [path, format, trajectory = main_projectile.get_trajectory(), parameters = projectile_parameters,
+                                                     count = main_projectile.sample_count, times = main_projectile.samples.adaptive_times()](){
+        std::string error {};
+        const bool exported = times.empty() ? export_trajectory(path, format, trajectory, parameters, count, error)
+                                            : export_trajectory(path, format, trajectory, parameters, times, error);
+        if (!exported)
+            return "Export failed: " + error;
+        return "Exported " + std::to_string(times.empty() ? count : times.size()) + " samples to " + path;
+    });
+    export_status = "Exporting...";
+}
+
+// Takes over the message of a finished export
+void collect_export(){
+    if (running_export.valid() && running_export.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        export_status = running_export.get();
+}
+
+// Input values of the table: the solved table holds every unknown too, so after a CALCULATE the inputs are the
+// ones handed to the solver
+const ParameterValues &input_parameters(){
+    return is_solved ? submitted_parameters : projectile_parameters;
+}
+
+// Solves the grid of the sweep settings on a pool of its own, the result is picked up by collect_sweep()
+void start_sweep(){
+    if (running_sweep.valid())
+        return;
+
+    sweep_base = input_parameters();
+    sweep_x = {static_cast<Parameter>(sweep_settings.x_parameter), sweep_settings.x_from, sweep_settings.x_to,
+               static_cast<std::size_t>(sweep_settings.x_steps)};
+    sweep_y = sweep_settings.sweep_y ? SweepAxis{static_cast<Parameter>(sweep_settings.y_parameter), sweep_settings.y_from, sweep_settings.y_to,
+                                                 static_cast<std::size_t>(sweep_settings.y_steps)}
+                                     : SweepAxis{sweep_x.parameter, sweep_x.from, sweep_x.from, 1};
+    sweep_objective = static_cast<Parameter>(sweep_settings.objective);
+    sweep_clock.restart();
+    running_sweep = std::async(std::launch::async, [base = sweep_base, x = sweep_x, y = sweep_y, objective = sweep_objective](){
+        thread_pool pool {};
+        return run_sweep(base, x, y, objective, pool);
+    });
+}
+
+// Colors the finished sweep into the heatmap texture, low values blue and high values red
+// Cells without a solution stay black, the best cell of every row (the envelope) is white
+void collect_sweep(){
+    if (!running_sweep.valid() || running_sweep.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+    sweep_result = running_sweep.get();
+    sweep_ms = sweep_clock.getElapsedTime().asSeconds() * 1000.f;
+
+    const std::size_t width = sweep_result.width, height = sweep_result.height;
+    const double span = sweep_result.max_value > sweep_result.min_value ? sweep_result.max_value - sweep_result.min_value : 1;
+    std::vector<std::uint8_t> pixels(width * height * 4);
+    for (std::size_t row = 0; row < height; row++){
+        const double *values = sweep_result.values.data() + row * width;
+        std::uint8_t *line = pixels.data() + (height - 1 - row) * width * 4; // First row at the bottom
+        for (std::size_t column = 0; column < width; column++){
+            const double value = values[column];
+            const double t = std::isnan(value) ? 0 : (value - sweep_result.min_value) / span;
+            std::uint8_t *pixel = line + column * 4;
+            pixel[0] = std::isnan(value) ? 0 : static_cast<std::uint8_t>(255 * t);
+            pixel[1] = std::isnan(value) ? 0 : static_cast<std::uint8_t>(255 * (1 - std::abs(2 * t - 1)) * 0.6);
+            pixel[2] = std::isnan(value) ? 0 : static_cast<std::uint8_t>(255 * (1 - t));
+            pixel[3] = 255;
+        }
+        if (sweep_result.height > 1 && sweep_result.row_best[row] != SweepResult::NO_CELL){
+            std::uint8_t *pixel = line + (sweep_result.row_best[row] - row * width) * 4;
+            pixel[0] = pixel[1] = pixel[2] = 255;
         }
     }
+    if (sweep_texture.resize({static_cast<unsigned int>(width), static_cast<unsigned int>(height)}))
+        sweep_texture.update(pixels.data());
+}
 
-    // Check if the threshold is reached and call the physics engine
-    if (required_scalar_count >= 3 || required_vector_count >= 3){
-        // Verify initial and final velocities are the same if both are given
-        if(projectile_parameters[Parameter::INITIAL_SPEED].value != 0.f && projectile_parameters[Parameter::FINAL_SPEED].value != 0.f) {
-            if (projectile_parameters[Parameter::INITIAL_SPEED].value != projectile_parameters[Parameter::FINAL_SPEED].value){
-                user_error_message = "Initial and Final speed are NOT the same!";
-                return;
-            }
-        }
+// Sweep settings, heatmap and optimum
+void render_sweep(){
+    static const char *parameter_names[PARAMETER_COUNT] {};
+    if (parameter_names[0] == nullptr){
+        for (const ParameterInfo &info : PARAMETER_INFO)
+            parameter_names[static_cast<std::size_t>(info.parameter)] = info.name;
+    }
 
-        if(projectile_parameters[Parameter::V_INITIAL_I_COMPONENT].value != 0.f && projectile_parameters[Parameter::V_FINAL_I_COMPONENT].value != 0.f) {
-            if(projectile_parameters[Parameter::V_INITIAL_I_COMPONENT].value != projectile_parameters[Parameter::V_FINAL_I_COMPONENT].value) {
-                user_error_message = "Initial and Final vertical (i) components are NOT the same!";
-                return;
-            }
-        }
+    ImGui::SetNextWindowPos(ImVec2(900.f, 10.f), ImGuiCond_Once);
+    ImGui::Begin("Parameter Sweep");
+    ImGui::PushItemWidth(120.0f);
 
-        if(projectile_parameters[Parameter::V_INITIAL_J_COMPONENT].value != 0.f && projectile_parameters[Parameter::V_FINAL_J_COMPONENT].value != 0.f) {
-            if(projectile_parameters[Parameter::V_INITIAL_J_COMPONENT].value != projectile_parameters[Parameter::V_FINAL_J_COMPONENT].value) {
-                user_error_message = "Initial and Final Horizontal (j) components are NOT the same!";
-                return;
+    ImGui::Combo("X parameter", &sweep_settings.x_parameter, parameter_names, static_cast<int>(PARAMETER_COUNT));
+    ImGui::InputDouble("X from", &sweep_settings.x_from, 0.0, 0.0, "%.2f"); ImGui::SameLine();
+    ImGui::InputDouble("X to", &sweep_settings.x_to, 0.0, 0.0, "%.2f");
+    ImGui::InputInt("X steps", &sweep_settings.x_steps, 10, 100);
+    ImGui::Checkbox("Sweep Y", &sweep_settings.sweep_y);
+    if (sweep_settings.sweep_y){
+        ImGui::Combo("Y parameter", &sweep_settings.y_parameter, parameter_names, static_cast<int>(PARAMETER_COUNT));
+        ImGui::InputDouble("Y from", &sweep_settings.y_from, 0.0, 0.0, "%.2f"); ImGui::SameLine();
+        ImGui::InputDouble("Y to", &sweep_settings.y_to, 0.0, 0.0, "%.2f");
+        ImGui::InputInt("Y steps", &sweep_settings.y_steps, 10, 100);
+    }
+    sweep_settings.x_steps = std::clamp(sweep_settings.x_steps, 1, MAX_SWEEP_STEPS);
+    sweep_settings.y_steps = std::clamp(sweep_settings.y_steps, 1, MAX_SWEEP_STEPS);
+    ImGui::Combo("Maximize", &sweep_settings.objective, parameter_names, static_cast<int>(PARAMETER_COUNT));
+
+    ImGui::BeginDisabled(running_sweep.valid());
+    if (ImGui::Button("SWEEP"))
+        start_sweep();
+    ImGui::EndDisabled();
+
+    if (running_sweep.valid()){
+        ImGui::SameLine();
+        ImGui::Text("Solving...");
+    }
+    else if (sweep_result.width > 0){
+        ImGui::SameLine();
+        ImGui::Text("%zu x %zu cells, %zu solved in %.1f ms", sweep_result.width, sweep_result.height, sweep_result.solved_cells, sweep_ms);
+
+        ImGui::Image(sweep_texture, {SWEEP_IMAGE_SIZE, SWEEP_IMAGE_SIZE});
+        ImGui::Text("%s: %.2f to %.2f", parameter_info(sweep_objective).name, sweep_result.min_value, sweep_result.max_value);
+
+        if (sweep_result.has_optimum()){
+            const std::size_t column = sweep_result.best_cell % sweep_result.width, row = sweep_result.best_cell / sweep_result.width;
+            ImGui::Text("Optimum %s = %.3f at %s = %.3f", parameter_info(sweep_objective).name, sweep_result.values[sweep_result.best_cell],
+                        parameter_info(sweep_x.parameter).name, sweep_x.value_at(column));
+            if (sweep_result.height > 1)
+                ImGui::Text("and %s = %.3f", parameter_info(sweep_y.parameter).name, sweep_y.value_at(row));
+
+            if (ImGui::Button("Use optimum")){ // Solves the input table of the best cell like CALCULATE does
+                sweep_cell(sweep_base, sweep_x, sweep_y, column, row, projectile_parameters);
+                cleanup_input();
             }
         }
+        else
+            ImGui::Text("No cell has a solution");
+    }
+    ImGui::End();
+}
 
-        // Inputs look valid, call the physics engine
-        find_unknown(
-            projectile_parameters[Parameter::Y_INITIAL].value,
-            projectile_parameters[Parameter::INITIAL_SPEED].value,
-            projectile_parameters[Parameter::FINAL_SPEED].value,
-            projectile_parameters[Parameter::ACC].value,
-            projectile_parameters[Parameter::TIME].value,
-            projectile_parameters[Parameter::MAX_HEIGHT].value,
-            projectile_parameters[Parameter::ABS_MAX_HEIGHT].value,
-            projectile_parameters[Parameter::RANGE].value,
-            projectile_parameters[Parameter::ANGLE].value,
-            projectile_parameters[Parameter::V_INITIAL_I_COMPONENT].value,
-            projectile_parameters[Parameter::V_INITIAL_J_COMPONENT].value,
-            projectile_parameters[Parameter::V_FINAL_I_COMPONENT].value,
-            projectile_parameters[Parameter::V_FINAL_J_COMPONENT].value,
-            projectile_parameters[Parameter::TIME_OF_APEX].value
-        );
-
-        // Check output value -> <0 means the input values lead to an impossible case
-        if(projectile_parameters[Parameter::MAX_HEIGHT].value  < 0) {
-            user_error_message = "User has entered inconsistent values!\nLook at the calculated value of Maximum Height!";
-            is_solved = false;
-            return;
-        }
-    } 
+// Draws the Monte Carlo samples on a pool of its own, the result is picked up by collect_monte_carlo()
+void start_monte_carlo(){
+    if (running_monte_carlo.valid())
+        return;
 
-    else {
-        user_error_message = "Not enough required inputs. Required scalar count = " + std::to_string(required_scalar_count) +
-                  ", required vector count = " + std::to_string(required_vector_count);
+    monte_carlo_clock.restart();
+    running_monte_carlo = std::async(std::launch::async, [inputs = input_parameters(), distributions = input_distributions,
+                                                          settings = monte_carlo_settings](){
+        thread_pool pool {};
+        return run_monte_carlo(inputs, distributions, settings, pool);
+    });
+}
+
+void collect_monte_carlo(){
+    if (!running_monte_carlo.valid() || running_monte_carlo.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+    monte_carlo_result = running_monte_carlo.get();
+    monte_carlo_ms = monte_carlo_clock.getElapsedTime().asSeconds() * 1000.f;
+
+    for (std::size_t o = 0; o < MONTE_CARLO_OUTPUT_COUNT; o++){
+        const std::vector<std::size_t> &histogram = monte_carlo_result.outputs[o].histogram;
+        monte_carlo_histograms[o].assign(histogram.begin(), histogram.end());
+        monte_carlo_histogram_peaks[o] = histogram.empty() ? 1.f : static_cast<float>(*std::max_element(histogram.begin(), histogram.end()));
     }
 }
 
-// Static object handler
-using shape_ptr = std::shared_ptr<sf::Shape>; // Bit cleaner to use shape_ptr instead of having to type all of that
-class static_object_manager{
-    protected:
-        std::vector<shape_ptr> object_list;
+// Distribution of every input, sample settings and the resulting output distributions
+void render_monte_carlo(){
+    static const char *DISTRIBUTION_NAMES[] {"Fixed", "Normal", "Uniform"};
 
-    public:
-        static_object_manager(){}
+    ImGui::SetNextWindowPos(ImVec2(900.f, 420.f), ImGuiCond_Once);
+    ImGui::Begin("Uncertainty");
+    ImGui::PushItemWidth(90.0f);
 
-        shape_ptr add_object(sf::RectangleShape square, const sf::Color &color, const Vector2 &pos){
-            square.setFillColor(color);
-            square.setPosition({pos.x, pos.y});
-            shape_ptr shape = std::make_shared<sf::RectangleShape>(square);
-            object_list.push_back(shape);
-            return shape;
-        }
+    // Only the inputs of the table can be uncertain
+    const ParameterValues &inputs = input_parameters();
+    for (const ParameterInfo &info : PARAMETER_INFO){
+        InputDistribution &distribution = input_distributions[info.parameter];
+        if (inputs[info.parameter] == 0.0 && distribution.kind != Distribution::UNIFORM)
+            continue;
 
-        shape_ptr add_object(sf::CircleShape circle, const sf::Color &color, const Vector2 &pos){
-            circle.setFillColor(color);
-            circle.setPosition({pos.x, pos.y});
-            shape_ptr shape = std::make_shared<sf::CircleShape>(circle);
-            object_list.push_back(shape);
-            return shape;
+        ImGui::PushID(info.name);
+        ImGui::Text("%s:", info.name); ImGui::SameLine(200);
+        int kind = static_cast<int>(distribution.kind);
+        if (ImGui::Combo("##kind", &kind, DISTRIBUTION_NAMES, 3))
+            distribution.kind = static_cast<Distribution>(kind);
+        if (distribution.kind == Distribution::NORMAL){
+            ImGui::SameLine(); ImGui::InputDouble("sigma", &distribution.sigma, 0.0, 0.0, "%.3f");
         }
-
-        void draw(){
-            for (const auto &object_ptr : object_list)
-                window->draw(*object_ptr);
+        else if (distribution.kind == Distribution::UNIFORM){
+            ImGui::SameLine(); ImGui::InputDouble("low", &distribution.low, 0.0, 0.0, "%.3f");
+            ImGui::SameLine(); ImGui::InputDouble("high", &distribution.high, 0.0, 0.0, "%.3f");
         }
+        ImGui::PopID();
+    }
 
-        void delete_object(shape_ptr &shape){
-            // Reset the pointer
-            shape.reset();
-            // Remove the pointer from the list
-            auto new_vct_end = std::remove(object_list.begin(), object_list.end(), shape);
-            object_list.erase(new_vct_end, object_list.end());
-        }
-};
-// Initialize the static object renderer
-static_object_manager static_object_renderer {};
+    int samples = static_cast<int>(monte_carlo_settings.samples);
+    if (ImGui::InputInt("Samples", &samples, 10000, 1000000))
+        monte_carlo_settings.samples = static_cast<std::size_t>(std::clamp(samples, 1, MAX_MONTE_CARLO_SAMPLES));
+    ImGui::SameLine();
+    int seed = static_cast<int>(monte_carlo_settings.seed);
+    if (ImGui::InputInt("Seed", &seed))
+        monte_carlo_settings.seed = static_cast<std::uint64_t>(seed);
 
-// Dynamic object handler
-class dynamic_object_manager: public static_object_manager{
-    public:
-        dynamic_object_manager(){}
+    ImGui::BeginDisabled(running_monte_carlo.valid());
+    if (ImGui::Button("RUN"))
+        start_monte_carlo();
+    ImGui::EndDisabled();
 
-        void move(const shape_ptr &obj, const Vector2 &d_pos){
-            obj->move({d_pos.x, d_pos.y});
-        }
+    ImGui::SameLine();
+    if (running_monte_carlo.valid())
+        ImGui::Text("Sampling...");
+    else if (monte_carlo_result.samples > 0)
+        ImGui::Text("%zu of %zu samples solved in %.1f ms", monte_carlo_result.solved, monte_carlo_result.samples, monte_carlo_ms);
+
+    if (!running_monte_carlo.valid() && monte_carlo_result.solved < monte_carlo_result.samples){
+        char error_message[512];
+        format_input_error(monte_carlo_result.first_rejection, error_message, sizeof(error_message));
+        ImGui::TextWrapped("First rejected sample: %s", error_message);
+    }
 
-        void set(const shape_ptr &obj, const Vector2 &d_pos){
-            obj->setPosition({d_pos.x, d_pos.y});
+    if (!running_monte_carlo.valid() && monte_carlo_result.solved > 0){
+        for (std::size_t o = 0; o < MONTE_CARLO_OUTPUT_COUNT; o++){
+            const OutputDistribution &output = monte_carlo_result.outputs[o];
+            ImGui::Separator();
+            ImGui::Text("%s: %.3f +- %.3f  [%.3f, %.3f]", parameter_info(MONTE_CARLO_OUTPUTS[o]).name, output.mean, output.stddev, output.min, output.max);
+            ImGui::Text("p5 %.3f  p25 %.3f  p50 %.3f  p75 %.3f  p95 %.3f", output.percentile[0], output.percentile[1], output.percentile[2],
+                        output.percentile[3], output.percentile[4]);
+            ImGui::PushID(static_cast<int>(o));
+            ImGui::PlotHistogram("##histogram", monte_carlo_histograms[o].data(), static_cast<int>(monte_carlo_histograms[o].size()), 0, nullptr,
+                                 0.f, monte_carlo_histogram_peaks[o], ImVec2(360.f, 50.f));
+            ImGui::PopID();
         }
+    }
+    ImGui::End();
+}
 
-};
-// Initialize the dynamic object handler
-dynamic_object_manager dynamic_object_handler {};
+// Solves every target again and rebuilds the markers and arcs, launch_x/launch_y is the launch point on the ground
+void solve_target_arcs(double launch_x, double launch_y){
+    sf::Clock clock {};
+    targets_refined = solve_targets(targeting_problem, targets);
+    targeting_ms = clock.getElapsedTime().asSeconds() * 1000.f;
+
+    const double height = static_cast<double>(window->getSize().y);
+    auto to_screen = [&](double x, double y){
+        return sf::Vector2f{static_cast<float>(launch_x + x), static_cast<float>(height - launch_y - y)};
+    };
+
+    target_arcs.clear();
+    targets_reached = 0;
+    const float m = TARGET_MARKER_SIZE;
+    for (std::size_t i = 0; i < targets.size(); i++){
+        const sf::Vector2f target = to_screen(targets.x[i], targets.y[i]);
+        const bool reached = !std::isnan(targets.angle[LOW_ARC][i]);
+        const sf::Color marker = reached ? sf::Color::Green : sf::Color::Red;
+        targets_reached += reached;
+        for (const sf::Vector2f &corner : {sf::Vector2f{-m, -m}, sf::Vector2f{m, m}, sf::Vector2f{-m, m}, sf::Vector2f{m, -m}})
+            target_arcs.append({target + corner, marker});
+
+        for (std::size_t arc = 0; arc < ARC_COUNT; arc++){
+            if (std::isnan(targets.angle[arc][i]))
+                continue;
+            const double radians = targets.angle[arc][i] * (M_PI / 180.0);
+            const double vx = targets.speed[arc][i] * std::cos(radians), vy = targets.speed[arc][i] * std::sin(radians);
+            const sf::Color color = arc == LOW_ARC ? sf::Color::Yellow : sf::Color::Cyan;
+            sf::Vector2f previous = to_screen(0, targeting_problem.y_initial);
+            for (int segment = 1; segment <= TARGET_ARC_SEGMENTS; segment++){
+                const double t = targets.time[arc][i] * segment / TARGET_ARC_SEGMENTS;
+                const sf::Vector2f point = to_screen(vx * t, targeting_problem.y_initial + vy * t + 0.5 * targeting_problem.acc * t * t);
+                target_arcs.append({previous, color});
+                target_arcs.append({point, color});
+                previous = point;
+            }
+        }
+    }
+}
 
-// Projectile Class
-class projectile_manager {
-    private:
-        shape_ptr object_ptr;
-        double t {0};
-        const double radius {30};
+// Target list, launch constraint and the solutions of the last targets
+void render_targeting(projectile_manager &main_projectile){
+    static const char *CONSTRAINT_NAMES[] {"Fixed speed", "Fixed angle"};
+    bool changed {false};
 
-    public:
-        std::vector<Vector2> pos_list;
-        const double start_x{15}, start_y{30};
-        double x, y;
+    ImGui::SetNextWindowPos(ImVec2(460.f, 420.f), ImGuiCond_Once);
+    ImGui::Begin("Targeting");
+    ImGui::PushItemWidth(90.0f);
 
-        // Normalizes coords to the bottom right of the screen
-        void normalize_coords(double &y){
-            double height = static_cast<float>(window->getSize().y);
-            y = height - y;
+    int constraint = static_cast<int>(targeting_problem.constraint);
+    if (ImGui::Combo("Constraint", &constraint, CONSTRAINT_NAMES, 2)){
+        targeting_problem.constraint = static_cast<TargetConstraint>(constraint);
+        changed = true;
+    }
+    ImGui::SameLine();
+    if (targeting_problem.constraint == TargetConstraint::FIXED_SPEED)
+        changed |= ImGui::InputDouble("Speed", &targeting_problem.speed, 0.0, 0.0, "%.2f");
+    else
+        changed |= ImGui::InputDouble("Angle", &targeting_problem.angle, 0.0, 0.0, "%.2f");
+    changed |= ImGui::InputDouble("Acceleration", &targeting_problem.acc, 0.0, 0.0, "%.2f");
+    ImGui::SameLine();
+    changed |= ImGui::InputDouble("Launch height", &targeting_problem.y_initial, 0.0, 0.0, "%.2f");
+    targeting_problem.acc = std::min(targeting_problem.acc, -0.01); // Targets are only reachable while gravity pulls down
+
+    ImGui::InputDouble("Target x", &new_target[0], 0.0, 0.0, "%.2f"); ImGui::SameLine();
+    ImGui::InputDouble("Target y", &new_target[1], 0.0, 0.0, "%.2f"); ImGui::SameLine();
+    if (ImGui::Button("Add")){
+        targets.x.push_back(new_target[0]);
+        targets.y.push_back(new_target[1]);
+        changed = true;
+    }
+    if (ImGui::Button("Scatter")){ // Random targets across the visible part of the scene
+        static std::uint64_t state {0x9E3779B97F4A7C15};
+        auto next_unit = [](){
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<double>(state >> 11) * 0x1.0p-53;
+        };
+        for (std::size_t i = 0; i < RANDOM_TARGETS; i++){
+            targets.x.push_back(next_unit() * (WIDTH - main_projectile.start_x));
+            targets.y.push_back(next_unit() * (HEIGHT - main_projectile.start_y));
         }
+        changed = true;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear targets")){
+        targets.x.clear();
+        targets.y.clear();
+        changed = true;
+    }
 
+    if (changed){
+        targets.resize(targets.x.size());
+        solve_target_arcs(main_projectile.start_x, main_projectile.start_y);
+    }
 
-        projectile_manager(){
-            this-> x = this->start_x;
-            this->y = start_y;
-            normalize_coords(this->y);
-
-            this->pos_list.push_back(Vector2(this->x, this->y));
-            auto circle = sf::CircleShape{this->radius};
-            circle.setOrigin({this->radius, this->radius});
-            this->object_ptr = dynamic_object_handler.add_object(circle, sf::Color::Red, Vector2(this->x, this->y));
+    if (targets.size() > 0){
+        ImGui::Text("%zu of %zu targets reachable, %zu refined, solved in %.3f ms", targets_reached, targets.size(), targets_refined, targeting_ms);
+        const std::size_t last = targets.size() - 1;
+        ImGui::Text("Last target (%.2f, %.2f):", targets.x[last], targets.y[last]);
+        for (std::size_t arc = 0; arc < ARC_COUNT; arc++){
+            if (std::isnan(targets.angle[arc][last]))
+                continue;
+            ImGui::Text("%s arc: angle %.3f deg, speed %.3f, time %.3f s", arc == LOW_ARC ? "Low" : "High", targets.angle[arc][last],
+                        targets.speed[arc][last], targets.time[arc][last]);
         }
+        if (std::isnan(targets.angle[LOW_ARC][last]))
+            ImGui::Text("Out of reach");
+    }
+    ImGui::End();
+}
 
-    void move(){
-        this->t += TIME_INTERVAL;
-        double angle_rad = projectile_parameters[Parameter::ANGLE].value * (M_PI / 180);
-        double v_initial_x {}, v_initial_y {};
+// Integrates the body of the Forces tab and hands its motion to the projectile
+void integrate_forces(projectile_manager &main_projectile){
+    ForceBody body {};
+    input_check = make_force_body(projectile_parameters, force_body_kind, force_drag[0], force_drag[1], body);
+    submitted_parameters = projectile_parameters; // The table keeps its inputs, nothing is solved into it
+    is_solved = input_check.ok();
+    force_integrated = false;
+    if (!is_solved)
+        return;
+
+    sf::Clock clock {};
+    std::vector<ForceRun> runs = integrate_bodies({body});
+    force_ms = clock.getElapsedTime().asSeconds() * 1000.f;
+    force_run = std::move(runs[0]);
+    force_integrated = true;
+    main_projectile.load_trajectory(make_trajectory(std::make_shared<const ForceTrajectory>(std::move(force_run.trajectory))));
+}
 
-        if (projectile_parameters[Parameter::INITIAL_SPEED].value != 0){
-            v_initial_x = projectile_parameters[Parameter::INITIAL_SPEED].value * std::cos(angle_rad);
-            v_initial_y = projectile_parameters[Parameter::INITIAL_SPEED].value * std::sin(angle_rad);
+// Integrates force_batch_bodies copies of the Forces tab body in one batch on a thread of its own: projectiles
+// launched at angles spread over (0, 90) degrees, blocks starting at speeds spread over [0, 2 v]
+// The counts are picked up by collect_force_batch()
+void start_force_batch(){
+    if (running_force_batch.valid())
+        return;
+    ForceBody body {};
+    input_check = make_force_body(projectile_parameters, force_body_kind, force_drag[0], force_drag[1], body);
+    if (!input_check.ok())
+        return;
+
+    const double speed = std::hypot(body.vx, body.vy);
+    std::vector<ForceBody> bodies(static_cast<std::size_t>(force_batch_bodies), body);
+    for (std::size_t i = 0; i < bodies.size(); i++){
+        const double spread = (i + 0.5) / bodies.size();
+        if (force_body_kind == BodyKind::PROJECTILE){
+            bodies[i].vx = speed * std::cos(spread * M_PI / 2);
+            bodies[i].vy = speed * std::sin(spread * M_PI / 2);
         }
-        else{
-            v_initial_x = projectile_parameters[Parameter::V_INITIAL_I_COMPONENT].value;
-            v_initial_y = projectile_parameters[Parameter::V_INITIAL_J_COMPONENT].value;
+        else
+            bodies[i].vx = 2 * speed * spread;
+    }
+
+    running_force_batch = std::async(std::launch::async, [bodies = std::move(bodies)](){
+        ForceSettings settings {};
+        settings.keep_trajectories = false; // Only the counts are shown
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<ForceRun> runs = integrate_bodies(bodies, settings);
+
+        ForceBatchStats stats {runs.size()};
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (const ForceRun &run : runs){
+            stats.accepted_steps += run.accepted_steps;
+            stats.rejected_steps += run.rejected_steps;
+            stats.most_steps = std::max(stats.most_steps, run.accepted_steps + run.rejected_steps);
+            stats.most_seconds = std::max(stats.most_seconds, run.seconds);
         }
+        return stats;
+    });
+}
 
-        double new_x = this->start_x + (v_initial_x * this->t);
-        double new_y = this->start_y + (v_initial_y * this->t + 0.5 * projectile_parameters[Parameter::ACC].value * pow(this->t, 2));
-        normalize_coords(new_y); // this->start_y
+void collect_force_batch(){
+    if (!running_force_batch.valid() || running_force_batch.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+    force_batch_stats = running_force_batch.get();
+}
 
-        double del_x = new_x - this->x; 
-        double del_y = new_y - this->y;
-        this->x += del_x; this->y += del_y; 
+// Launches the volley of the settings next to whatever is already flying
+void launch_volley(){
+    const std::size_t room = static_cast<std::size_t>(MAX_VOLLEY_PROJECTILES) - volley_projectiles.size();
+    const std::size_t count = std::min(static_cast<std::size_t>(volley_settings.count), room);
+    if (volley_settings.kind == 0){
+        volley_projectiles.add_fan(volley_settings.launch, volley_settings.angle_from, volley_settings.angle_to, count);
+        volley_markers.add(count, sf::Color::Yellow, sf::Color::Magenta); // Low angles yellow, high angles magenta
+    }
+    else{
+        volley_projectiles.add_cloud(volley_settings.launch, volley_settings.speed_sigma, volley_settings.angle_sigma, count,
+                                     static_cast<std::uint64_t>(volley_settings.seed));
+        volley_markers.add(count, sf::Color::Cyan, sf::Color::Cyan);
+    }
+    volley_flying = !volley_projectiles.all_landed();
+    volley_moved = true;
+    volley_stepper.reset();
+}
 
-        double height = static_cast<float>(window->getSize().y);
-        if (height - this->y < 0){;
-            stop_time = true;
-            this->y = this->start_y;
-            normalize_coords(this->y);
+// Steps the volley by the fixed steps that are due, like the main projectile, volleys start where it starts
+void update_volley(const projectile_manager &main_projectile, double real_seconds){
+    if (volley_flying){
+        const int steps = volley_stepper.accumulate(real_seconds);
+        if (steps > 0){
+            sf::Clock clock {};
+            volley_projectiles.advance(steps * TIME_INTERVAL, volley_pool, &scene_obstacles, main_projectile.start_x, main_projectile.start_y);
+            volley_step_ms = clock.getElapsedTime().asSeconds() * 1000.f;
+            volley_flying = !volley_projectiles.all_landed();
+            volley_moved = true;
         }
+    }
+    if (volley_moved){
+        sf::Clock clock {};
+        const float height = static_cast<float>(window->getSize().y);
+        volley_markers.update(volley_projectiles, volley_pool, static_cast<float>(main_projectile.start_x),
+                              height - static_cast<float>(main_projectile.start_y));
+        volley_place_ms = clock.getElapsedTime().asSeconds() * 1000.f;
+        volley_moved = false;
+    }
+}
+
+// Volley settings and what it costs to move and draw every projectile
+void render_volley(){
+    static const char *KIND_NAMES[] {"Angle fan", "Cloud"};
 
-        dynamic_object_handler.move(this->object_ptr, Vector2(del_x, del_y));
-        this->pos_list.push_back(Vector2(this->x, this->y));// So we can let the user more back and forwards in the frame
+    ImGui::SetNextWindowPos(ImVec2(460.f, 10.f), ImGuiCond_Once);
+    ImGui::Begin("Volley");
+    ImGui::PushItemWidth(90.0f);
+
+    ImGui::Combo("Kind", &volley_settings.kind, KIND_NAMES, 2);
+    ImGui::SameLine();
+    ImGui::InputInt("Projectiles", &volley_settings.count, 1000, 10000);
+    volley_settings.count = std::clamp(volley_settings.count, 1, MAX_VOLLEY_PROJECTILES);
+    ImGui::InputDouble("Speed", &volley_settings.launch.speed, 0.0, 0.0, "%.2f"); ImGui::SameLine();
+    ImGui::InputDouble("Acceleration", &volley_settings.launch.acc, 0.0, 0.0, "%.2f");
+    ImGui::InputDouble("Launch height", &volley_settings.launch.y_initial, 0.0, 0.0, "%.2f");
+    if (volley_settings.kind == 0){
+        ImGui::InputDouble("Angle from", &volley_settings.angle_from, 0.0, 0.0, "%.2f"); ImGui::SameLine();
+        ImGui::InputDouble("to", &volley_settings.angle_to, 0.0, 0.0, "%.2f");
     }
-    void update_projectile(){
-        dynamic_object_handler.set(this->object_ptr, Vector2(this->x, this->y));
-        }
+    else{
+        ImGui::InputDouble("Angle", &volley_settings.launch.angle, 0.0, 0.0, "%.2f"); ImGui::SameLine();
+        ImGui::InputInt("Seed", &volley_settings.seed);
+        ImGui::InputDouble("Speed sigma", &volley_settings.speed_sigma, 0.0, 0.0, "%.2f"); ImGui::SameLine();
+        ImGui::InputDouble("Angle sigma", &volley_settings.angle_sigma, 0.0, 0.0, "%.2f");
+    }
+    volley_settings.launch.acc = std::min(volley_settings.launch.acc, -0.01); // Every projectile has to come down
+    volley_settings.launch.y_initial = std::max(volley_settings.launch.y_initial, 0.0);
 
+    if (ImGui::Button("Launch"))
+        launch_volley();
+    ImGui::SameLine();
+    if (ImGui::Button("Clear volley")){
+        volley_projectiles.clear();
+        volley_markers.clear();
+        volley_flying = false;
+        volley_moved = true;
+    }
 
-};
+    if (volley_projectiles.size() > 0){
+        ImGui::Text("%zu projectiles, %zu flying", volley_projectiles.size(), volley_projectiles.size() - volley_projectiles.landed());
+        ImGui::Text("Step %.3f ms, markers %.3f ms on %u threads", volley_step_ms, volley_place_ms, volley_pool.size());
+    }
+    ImGui::End();
+}
 
-// Dotted line handler
-class dotted_line_manager {
-    private:
-        std::vector<shape_ptr> line_list {};
+// Hashes the obstacle list again and cuts the projectile at the new first hit
+void rebuild_obstacles(projectile_manager &main_projectile){
+    sf::Clock clock {};
+    scene_obstacles.build(obstacle_boxes);
+    obstacle_build_ms = clock.getElapsedTime().asSeconds() * 1000.f;
+    stop_time = true;
+    main_projectile.reload();
+}
 
-    public:
-        dotted_line_manager(){}
+// Adds a box to the obstacles and draws it with the static shapes
+void add_obstacle(const Obstacle &box){
+    const double height = static_cast<double>(window->getSize().y);
+    obstacle_boxes.push_back(box);
+    obstacle_shapes.push_back(static_object_renderer.add_object(
+        sf::RectangleShape({static_cast<float>(box.right - box.left), static_cast<float>(box.top - box.bottom)}),
+        sf::Color(150, 110, 60), Vector2(box.left, height - box.top)));
+}
 
-        void reformat_line(const std::vector<Vector2> &pos_list){
-            for (shape_ptr ptr : line_list){
-                static_object_renderer.delete_object(ptr);
-            }
+// Obstacle list, what it costs to hash it and where the projectile hits
+void render_obstacles(projectile_manager &main_projectile){
+    static const char *FACE_NAMES[] {"left", "right", "bottom", "top"};
+    bool changed {false};
+
+    ImGui::SetNextWindowPos(ImVec2(460.f, 280.f), ImGuiCond_Once);
+    ImGui::Begin("Obstacles");
+    ImGui::PushItemWidth(70.0f);
+
+    ImGui::InputDouble("x", &new_obstacle[0], 0.0, 0.0, "%.1f"); ImGui::SameLine();
+    ImGui::InputDouble("y", &new_obstacle[1], 0.0, 0.0, "%.1f"); ImGui::SameLine();
+    ImGui::InputDouble("w", &new_obstacle[2], 0.0, 0.0, "%.1f"); ImGui::SameLine();
+    ImGui::InputDouble("h", &new_obstacle[3], 0.0, 0.0, "%.1f");
+    new_obstacle[2] = std::max(new_obstacle[2], 1.0);
+    new_obstacle[3] = std::max(new_obstacle[3], 1.0);
+    if (ImGui::Button("Add")){
+        add_obstacle({new_obstacle[0], new_obstacle[1], new_obstacle[0] + new_obstacle[2], new_obstacle[1] + new_obstacle[3]});
+        changed = true;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Scatter")){ // Small random boxes across the visible part of the scene, clear of the launch point
+        static std::uint64_t state {0xC2B2AE3D27D4EB4F};
+        auto next_unit = [](){
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<double>(state >> 11) * 0x1.0p-53;
+        };
+        for (std::size_t i = 0; i < RANDOM_OBSTACLES; i++){
+            const double x = 200 + next_unit() * (WIDTH - 200), y = next_unit() * HEIGHT;
+            const double w = 4 + next_unit() * 12, h = 4 + next_unit() * 12;
+            add_obstacle({x, y, x + w, y + h});
+        }
+        changed = true;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear obstacles")){
+        for (slot_handle &shape : obstacle_shapes)
+            static_object_renderer.delete_object(shape);
+        obstacle_shapes.clear();
+        obstacle_boxes.clear();
+        changed = true;
+    }
 
-            for (Vector2 pos : pos_list){
-                static_object_renderer.add_object(sf::CircleShape{4.f}, sf::Color::White, pos);
-            }
+    if (changed)
+        rebuild_obstacles(main_projectile);
+
+    if (scene_obstacles.size() > 0){
+        ImGui::Text("%zu obstacles, cell %.1f, hashed in %.3f ms", scene_obstacles.size(), scene_obstacles.cell(), obstacle_build_ms);
+        const ObstacleHit &hit = main_projectile.get_obstacle_hit();
+        if (hit.hit){
+            const Obstacle &box = scene_obstacles[hit.obstacle];
+            ImGui::Text("Projectile hits the %s of (%.1f, %.1f) at t = %.3f s", FACE_NAMES[static_cast<int>(hit.face)], box.left, box.bottom, hit.time);
         }
-};
+        else
+            ImGui::Text("Projectile misses every obstacle");
+    }
+    ImGui::End();
+}
 
-// Sets all the values in the map to their default values - runs when clear button is pressed or when the user switches tabs in the GUI
+// Sets all the values in the table to their default values - runs when clear button is pressed or when the user switches tabs in the GUI
 void clear_userInput(projectile_manager &main_projectile) {
-    for (auto &[_, info] : projectile_parameters){
-        info.value = info.default_value;
-    }
+    projectile_parameters.reset();
+    gui_solver.cancel();
 
-    user_error_message = ""; // Clear error message string
+    input_check = {}; // Clear error message
     is_solved = false;
+    force_integrated = false;
     stop_time = true;
-    main_projectile.x = main_projectile.start_x;
-    main_projectile.y = main_projectile.start_y;
-    main_projectile.normalize_coords(main_projectile.y);
-    main_projectile.update_projectile();
-    main_projectile.pos_list.clear();
+    main_projectile.load_trajectory(); // Nothing solved, puts the projectile back at the start
 }
 
 // Handles all of the keyboard interactions
-void process_keyboard(){
+void process_keyboard(projectile_manager &main_projectile){
+    // Arrow keys belong to the input fields while one of them is being edited
+    if (ImGui::GetIO().WantTextInput)
+        return;
+
     if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_P))) {
         stop_time = !stop_time;
     }
-    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_LeftArrow))) {
+    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_LeftArrow))) { // Step back, held down keeps stepping
+        main_projectile.seek(main_projectile.playback.get_time() - TIME_INTERVAL);
+    }
+    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_RightArrow))) { // Step forward
+        main_projectile.seek(main_projectile.playback.get_time() + TIME_INTERVAL);
+    }
+    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Equal))) { // Zoom in
+        zoom_camera(1 / ZOOM_STEP);
+    }
+    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Minus))) { // Zoom out
+        zoom_camera(ZOOM_STEP);
     }
-    if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_RightAlt))) {
+    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_F), false)) {
+        follow_projectile = !follow_projectile;
     }
 }
 
@@ -560,14 +1118,14 @@ void render_gui(projectile_manager &main_projectile){
                         table_state = ParameterTable::KINEMATICS_SCALAR;
                     }
 
-                    ImGui::Text("Initial Speed (m/s):");       ImGui::SameLine(200); ImGui::InputDouble("##initSpeed", &projectile_parameters[Parameter::INITIAL_SPEED].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Final Speed (m/s):");         ImGui::SameLine(200); ImGui::InputDouble("##finalSpeed", &projectile_parameters[Parameter::FINAL_SPEED].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Initial Height (m):");        ImGui::SameLine(200); ImGui::InputDouble("##initHeight", &projectile_parameters[Parameter::Y_INITIAL].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Y-Acceleration (m/s²):");     ImGui::SameLine(200); ImGui::InputDouble("##yAccel", &projectile_parameters[Parameter::ACC].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Launch Angle (°):");          ImGui::SameLine(200); ImGui::InputDouble("##angle", &projectile_parameters[Parameter::ANGLE].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Time (s):");                  ImGui::SameLine(200); ImGui::InputDouble("##time", &projectile_parameters[Parameter::TIME].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Distance (m):");              ImGui::SameLine(200); ImGui::InputDouble("##distance", &projectile_parameters[Parameter::RANGE].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Maximum Height (m):");        ImGui::SameLine(200); ImGui::InputDouble("##maxHeight", &projectile_parameters[Parameter::MAX_HEIGHT].value, 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Initial Speed (m/s):");       ImGui::SameLine(200); ImGui::InputDouble("##initSpeed", &projectile_parameters[Parameter::INITIAL_SPEED], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Final Speed (m/s):");         ImGui::SameLine(200); ImGui::InputDouble("##finalSpeed", &projectile_parameters[Parameter::FINAL_SPEED], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Initial Height (m):");        ImGui::SameLine(200); ImGui::InputDouble("##initHeight", &projectile_parameters[Parameter::Y_INITIAL], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Y-Acceleration (m/s²):");     ImGui::SameLine(200); ImGui::InputDouble("##yAccel", &projectile_parameters[Parameter::ACC], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Launch Angle (°):");          ImGui::SameLine(200); ImGui::InputDouble("##angle", &projectile_parameters[Parameter::ANGLE], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Time (s):");                  ImGui::SameLine(200); ImGui::InputDouble("##time", &projectile_parameters[Parameter::TIME], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Distance (m):");              ImGui::SameLine(200); ImGui::InputDouble("##distance", &projectile_parameters[Parameter::RANGE], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Maximum Height (m):");        ImGui::SameLine(200); ImGui::InputDouble("##maxHeight", &projectile_parameters[Parameter::MAX_HEIGHT], 0.0f, 0.0f, "%.2f");
 
                     ImGui::EndTabItem();
                 }
@@ -579,15 +1137,15 @@ void render_gui(projectile_manager &main_projectile){
                         table_state = ParameterTable::KINEMATICS_VECTOR;
                     }
 
-                    ImGui::Text("Initial i Velocity (m/s):");    ImGui::SameLine(200); ImGui::InputDouble("##initVel_i", &projectile_parameters[Parameter::V_INITIAL_I_COMPONENT].value, 0.f, 0.f, "%.2f");
-                    ImGui::Text("Initial j Velocity (m/s):");    ImGui::SameLine(200); ImGui::InputDouble("##initVel_j", &projectile_parameters[Parameter::V_INITIAL_J_COMPONENT].value, 0.f, 0.f, "%.2f");
-                    ImGui::Text("Final i Velocity (m/s):");      ImGui::SameLine(200); ImGui::InputDouble("##finalVel_i", &projectile_parameters[Parameter::V_FINAL_I_COMPONENT].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Final j Velocity (m/s):");      ImGui::SameLine(200); ImGui::InputDouble("##finalVel_j", &projectile_parameters[Parameter::V_FINAL_J_COMPONENT].value, 0.0f, 0.0f, "%.2f"); // Passing values kept same because j-components are always the same
-                    ImGui::Text("Initial Height (m):");        ImGui::SameLine(200); ImGui::InputDouble("##initHeight", &projectile_parameters[Parameter::Y_INITIAL].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Y-Acceleration (m/s²):");     ImGui::SameLine(200); ImGui::InputDouble("##yAccel", &projectile_parameters[Parameter::ACC].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Time (s):");                  ImGui::SameLine(200); ImGui::InputDouble("##time", &projectile_parameters[Parameter::TIME].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Distance (m):");              ImGui::SameLine(200); ImGui::InputDouble("##distance", &projectile_parameters[Parameter::RANGE].value, 0.0f, 0.0f, "%.2f");
-                    ImGui::Text("Maximum Height (m):");        ImGui::SameLine(200); ImGui::InputDouble("##maxHeight", &projectile_parameters[Parameter::MAX_HEIGHT].value, 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Initial i Velocity (m/s):");    ImGui::SameLine(200); ImGui::InputDouble("##initVel_i", &projectile_parameters[Parameter::V_INITIAL_I_COMPONENT], 0.f, 0.f, "%.2f");
+                    ImGui::Text("Initial j Velocity (m/s):");    ImGui::SameLine(200); ImGui::InputDouble("##initVel_j", &projectile_parameters[Parameter::V_INITIAL_J_COMPONENT], 0.f, 0.f, "%.2f");
+                    ImGui::Text("Final i Velocity (m/s):");      ImGui::SameLine(200); ImGui::InputDouble("##finalVel_i", &projectile_parameters[Parameter::V_FINAL_I_COMPONENT], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Final j Velocity (m/s):");      ImGui::SameLine(200); ImGui::InputDouble("##finalVel_j", &projectile_parameters[Parameter::V_FINAL_J_COMPONENT], 0.0f, 0.0f, "%.2f"); // Passing values kept same because j-components are always the same
+                    ImGui::Text("Initial Height (m):");        ImGui::SameLine(200); ImGui::InputDouble("##initHeight", &projectile_parameters[Parameter::Y_INITIAL], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Y-Acceleration (m/s²):");     ImGui::SameLine(200); ImGui::InputDouble("##yAccel", &projectile_parameters[Parameter::ACC], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Time (s):");                  ImGui::SameLine(200); ImGui::InputDouble("##time", &projectile_parameters[Parameter::TIME], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Distance (m):");              ImGui::SameLine(200); ImGui::InputDouble("##distance", &projectile_parameters[Parameter::RANGE], 0.0f, 0.0f, "%.2f");
+                    ImGui::Text("Maximum Height (m):");        ImGui::SameLine(200); ImGui::InputDouble("##maxHeight", &projectile_parameters[Parameter::MAX_HEIGHT], 0.0f, 0.0f, "%.2f");
 
                     ImGui::EndTabItem();
                 }
@@ -601,7 +1159,7 @@ void render_gui(projectile_manager &main_projectile){
             ImGui::BeginDisabled();  // prevents user editing but still shows the inputs normally
             // --- Output Fields ---
             ImGui::Text("Time of Apex (s):"); ImGui::SameLine(200);
-            ImGui::InputDouble("##timeFlight", &projectile_parameters[Parameter::TIME_OF_APEX].value, 0.0f, 0.0f, "%.2f");
+            ImGui::InputDouble("##timeFlight", &projectile_parameters[Parameter::TIME_OF_APEX], 0.0f, 0.0f, "%.2f");
             //--- End of Results Section ---
             ImGui::EndDisabled();
             ImGui::PopItemWidth();
@@ -617,15 +1175,53 @@ void render_gui(projectile_manager &main_projectile){
                 table_state = ParameterTable::FORCES;
             }
 
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.0f, 10.0f, 1.0f, 1.0f));
-            ImGui::Text(" !!!!!!!!!!!!!!! Coming Soon !!!!!!!!!!!!!!!");
-            ImGui::PopStyleColor();
-            ImGui::BeginDisabled();  // prevents user editing but still shows the inputs normally
-            ImGui::Text("Friction Coefficiant (Mu):");              ImGui::SameLine(200); ImGui::InputDouble("##friction", &projectile_parameters[Parameter::COEFF_FRICTION].value, 0.0f, 0.0f, "%.3f");
-            ImGui::Text("Force (N):");         ImGui::SameLine(200); ImGui::InputDouble("##initForce", &projectile_parameters[Parameter::FORCE].value, 0.0f, 0.0f, "%.2f");
-            ImGui::Text("Time (s):");                  ImGui::SameLine(200); ImGui::InputDouble("##time", &projectile_parameters[Parameter::TIME].value, 0.0f, 0.0f, "%.2f");
-            ImGui::Text("Mass (kg):");                 ImGui::SameLine(200); ImGui::InputDouble("##mass", &projectile_parameters[Parameter::MASS].value, 0.0f, 0.0f, "%.2f");
+            static const char *BODY_NAMES[] {"Sliding block", "Projectile"};
+            int body_kind = static_cast<int>(force_body_kind);
+            ImGui::Text("Body:");                      ImGui::SameLine(200); ImGui::Combo("##bodyKind", &body_kind, BODY_NAMES, 2);
+            force_body_kind = static_cast<BodyKind>(body_kind);
+
+            ImGui::Text("Mass (kg):");                 ImGui::SameLine(200); ImGui::InputDouble("##mass", &projectile_parameters[Parameter::MASS], 0.0f, 0.0f, "%.2f");
+            ImGui::Text("Initial Speed (m/s):");       ImGui::SameLine(200); ImGui::InputDouble("##initSpeed", &projectile_parameters[Parameter::INITIAL_SPEED], 0.0f, 0.0f, "%.2f");
+            if (force_body_kind == BodyKind::BLOCK){
+                ImGui::Text("Friction Coefficiant (Mu):"); ImGui::SameLine(200); ImGui::InputDouble("##friction", &projectile_parameters[Parameter::COEFF_FRICTION], 0.0f, 0.0f, "%.3f");
+                ImGui::Text("Force (N):");             ImGui::SameLine(200); ImGui::InputDouble("##initForce", &projectile_parameters[Parameter::FORCE], 0.0f, 0.0f, "%.2f");
+                ImGui::Text("Time (s):");              ImGui::SameLine(200); ImGui::InputDouble("##time", &projectile_parameters[Parameter::TIME], 0.0f, 0.0f, "%.2f");
+            }
+            else{
+                ImGui::Text("Launch Angle (°):");      ImGui::SameLine(200); ImGui::InputDouble("##angle", &projectile_parameters[Parameter::ANGLE], 0.0f, 0.0f, "%.2f");
+                ImGui::Text("Initial Height (m):");    ImGui::SameLine(200); ImGui::InputDouble("##initHeight", &projectile_parameters[Parameter::Y_INITIAL], 0.0f, 0.0f, "%.2f");
+                ImGui::Text("Time Limit (s):");        ImGui::SameLine(200); ImGui::InputDouble("##time", &projectile_parameters[Parameter::TIME], 0.0f, 0.0f, "%.2f");
+            }
+            ImGui::Text("Y-Acceleration (m/s²):");     ImGui::SameLine(200); ImGui::InputDouble("##yAccel", &projectile_parameters[Parameter::ACC], 0.0f, 0.0f, "%.2f");
+            ImGui::Text("Linear Drag (N s/m):");       ImGui::SameLine(200); ImGui::InputDouble("##linearDrag", &force_drag[0], 0.0f, 0.0f, "%.4f");
+            ImGui::Text("Quadratic Drag (N s²/m²):");  ImGui::SameLine(200); ImGui::InputDouble("##quadraticDrag", &force_drag[1], 0.0f, 0.0f, "%.4f");
+
+            if (force_integrated){
+                static const char *END_NAMES[] {"time limit", "landed", "stopped", "step limit"};
+                const Trajectory &trajectory = main_projectile.get_trajectory();
+                const double end = trajectory.end_time;
+                ImGui::Text("Ended (%s) at %.3f s: x = %.3f m, speed %.3f m/s", END_NAMES[static_cast<int>(force_run.end)], end,
+                            trajectory.x_at(end), std::hypot(trajectory.vx_at(end), trajectory.vy_at(end)));
+                ImGui::Text("%zu steps, %zu rejected, %zu evaluations in %.3f ms", force_run.accepted_steps, force_run.rejected_steps,
+                            force_run.evaluations, force_ms);
+            }
+
+            ImGui::InputInt("Batch bodies", &force_batch_bodies, 100, 10000);
+            force_batch_bodies = std::clamp(force_batch_bodies, 1, MAX_FORCE_BATCH_BODIES);
+            ImGui::SameLine();
+            ImGui::BeginDisabled(running_force_batch.valid());
+            if (ImGui::Button("Integrate batch"))
+                start_force_batch();
             ImGui::EndDisabled();
+            if (running_force_batch.valid())
+                ImGui::Text("Integrating...");
+            else if (force_batch_stats.bodies > 0){
+                const double bodies = static_cast<double>(force_batch_stats.bodies);
+                ImGui::Text("%zu bodies in %.1f ms: %.1f steps (%.1f rejected) per body, at most %zu", force_batch_stats.bodies,
+                            force_batch_stats.seconds * 1000, force_batch_stats.accepted_steps / bodies, force_batch_stats.rejected_steps / bodies,
+                            force_batch_stats.most_steps);
+                ImGui::Text("%.2f us per body, at most %.2f us", force_batch_stats.seconds * 1e6 / bodies, force_batch_stats.most_seconds * 1e6);
+            }
 
             ImGui::EndTabItem();
         }
@@ -637,12 +1233,29 @@ void render_gui(projectile_manager &main_projectile){
 
         ImGui::BeginChild("ErrorBox", ImVec2(0, 60), true);
         ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.0f, 10.0f, 1.0f, 1.0f));
-        ImGui::TextWrapped("%s", user_error_message.c_str());
+        if (gui_solver.busy()){
+            ImGui::TextWrapped("Solving...");
+        }
+        else if (!input_check.ok()){
+            char error_message[512];
+            format_input_error(input_check, error_message, sizeof(error_message));
+            ImGui::TextWrapped("%s", error_message);
+        }
         ImGui::PopStyleColor();
         ImGui::EndChild();
 
+        ImGui::Text("Frame: %.2f ms, %u scene draw calls, %zu chunks, %zu stripes (detail level %d)", frame_stats.frame_ms,
+                    frame_stats.draw_calls, frame_stats.chunks_drawn, background_stripes.stripes(), background_stripes.level());
+        ImGui::Checkbox("Follow projectile (F)", &follow_projectile); ImGui::SameLine();
+        ImGui::Text("Zoom %.2fx (wheel, +/-)", 1 / camera_zoom); ImGui::SameLine();
+        if (ImGui::Button("Reset camera"))
+            reset_camera();
+
         if(ImGui::Button("CALCULATE")) {
-            cleanup_input();
+            if (table_state == ParameterTable::FORCES)
+                integrate_forces(main_projectile);
+            else
+                cleanup_input();
         }
 
         ImGui::SameLine(100); if(ImGui::Button("CLEAR")) {
@@ -658,92 +1271,220 @@ void render_gui(projectile_manager &main_projectile){
     ImGui::SetNextWindowPos(ImVec2(10.f,490.f), ImGuiCond_Once);
     // --- Trajectory Data Tab ---
     ImGui::Begin("Trajectory Data");
-    // Dummy data for now — your program will fill this later
-    static std::vector<float> timeValues = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
-    static std::vector<float> xValues    = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
-    static std::vector<float> yValues    = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
     // --- Layout Settings ---
     ImGui::PushItemWidth(120.0f);
     // Playback controls
-    ImGui::Button("<<"); 
+    if (ImGui::Button("<<")){
+        main_projectile.seek(main_projectile.playback.get_time() - TIME_INTERVAL);
+    }
     ImGui::SameLine();
     if (ImGui::Button(stop_time ? "Play" : "Pause")){
         if (!is_solved){
-            user_error_message = "Can not play without values";
+            input_check = {InputError::NOT_SOLVED};
 
         }
         else{
+            if (stop_time && main_projectile.playback.at_end()) // Play again from the start after landing
+                main_projectile.seek(0);
             stop_time = !stop_time;
         }
 
     }
     ImGui::SameLine();
-    ImGui::Button(">>");
+    if (ImGui::Button(">>")){
+        main_projectile.seek(main_projectile.playback.get_time() + TIME_INTERVAL);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(">>|")){ // Fast-forward to the landing without rendering the steps in between
+        if (!is_solved)
+            input_check = {InputError::NOT_SOLVED};
+        else
+            main_projectile.fast_forward();
+    }
+
+    // Scrubbing and playback speed
+    float scrub_time = static_cast<float>(main_projectile.playback.get_time());
+    if (ImGui::SliderFloat("Time##scrub", &scrub_time, 0.f, static_cast<float>(main_projectile.playback.get_end()), "%.2f s")){
+        main_projectile.seek(scrub_time);
+    }
+    ImGui::SameLine();
+    float speed = static_cast<float>(main_projectile.playback.get_speed());
+    if (ImGui::SliderFloat("Speed", &speed, 0.1f, 10.f, "%.1fx", ImGuiSliderFlags_Logarithmic)){
+        main_projectile.playback.set_speed(speed);
+    }
+
+    // Rows where the path bends as far as the error bound needs, or a number of evenly spaced rows
+    static const char *SPACING_NAMES[] {"Adaptive", "Evenly spaced"};
+    int spacing = main_projectile.even_samples ? 1 : 0;
+    if (ImGui::Combo("Rows", &spacing, SPACING_NAMES, 2))
+        main_projectile.set_even_samples(spacing == 1);
+    ImGui::SameLine();
+    if (main_projectile.even_samples){
+        int sample_count = static_cast<int>(main_projectile.sample_count);
+        if (ImGui::InputInt("Samples", &sample_count, 100, 10000)){
+            main_projectile.set_sample_count(static_cast<std::size_t>(std::clamp(sample_count, 2, MAX_TABLE_SAMPLES)));
+        }
+    }
+    else{
+        double tolerance = main_projectile.sample_tolerance;
+        if (ImGui::InputDouble("Max error (m)", &tolerance, 0.0, 0.0, "%.6g") && tolerance != main_projectile.sample_tolerance)
+            main_projectile.set_sample_tolerance(std::max(tolerance, MIN_SAMPLE_TOLERANCE));
+    }
+    ImGui::SameLine();
+    ImGui::Text("%zu rows, trail %zu points", main_projectile.samples.size(), main_projectile.path.size());
+
+    // Export the samples as they are in the table, evenly spaced ones are computed again while writing so any count fits in memory
+    ImGui::BeginDisabled(running_export.valid());
+    const bool export_binary = ImGui::Button("Export binary");
+    ImGui::SameLine();
+    const bool export_csv = ImGui::Button("Export CSV");
+    ImGui::EndDisabled();
+    if (export_binary || export_csv){
+        if (!is_solved)
+            input_check = {InputError::NOT_SOLVED};
+        else
+            start_export(main_projectile, export_binary ? ExportFormat::BINARY : ExportFormat::CSV);
+    }
+    if (!export_status.empty()){
+        ImGui::SameLine();
+        ImGui::Text("%s", export_status.c_str());
+    }
+
     // Create table with borders and row backgrounds
-    if (ImGui::BeginTable("TrajectoryTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    // Only the visible rows are laid out, and their samples are generated on first sight
+    trajectory_samples &samples = main_projectile.samples;
+    if (ImGui::BeginTable("TrajectoryTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0.f, 200.f)))
     {
+        ImGui::TableSetupScrollFreeze(0, 1); // Keep the header visible
         ImGui::TableSetupColumn("Time (s)");
         ImGui::TableSetupColumn("X Distance (m)");
-        ImGui::TableSetupColumn("Y Distance (m)");
+        ImGui::TableSetupColumn("Height (m)");
         ImGui::TableHeadersRow();
         // Fill rows with data
-        for (size_t i = 0; i < timeValues.size(); i++)
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(samples.size()));
+        while (clipper.Step())
         {
-            ImGui::TableNextRow();
-            ImGui::TableSetColumnIndex(0); ImGui::Text("%.2f", timeValues[i]);
-            ImGui::TableSetColumnIndex(1); ImGui::Text("%.2f", xValues[i]);
-            ImGui::TableSetColumnIndex(2); ImGui::Text("%.2f", yValues[i]);
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+            {
+                const trajectory_samples::Sample &sample = samples[static_cast<std::size_t>(row)];
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0); ImGui::Text("%.2f", sample.time);
+                ImGui::TableSetColumnIndex(1); ImGui::Text("%.2f", sample.x);
+                ImGui::TableSetColumnIndex(2); ImGui::Text("%.2f", sample.y);
+            }
         }
         ImGui::EndTable(); 
     }
     ImGui::End();
 }
 
-// Check if the projectile left the screen
-bool is_projectile_off_screen(projectile_manager &main_projectile){
-    return (main_projectile.x + 30 < 0 ||        // left
-            main_projectile.x > WIDTH ||         // right
-            main_projectile.y + 30 < 0 ||        // top
-            main_projectile.y > HEIGHT);         // bottom
+// Moves the camera just enough to keep the projectile out of the margins of the view, nothing moves while it is inside
+void follow_camera(const projectile_manager &main_projectile){
+    const sf::FloatRect view = camera_rect();
+    const float margin_x = view.size.x * FOLLOW_MARGIN, margin_y = view.size.y * FOLLOW_MARGIN;
+    const float x = static_cast<float>(main_projectile.x), y = static_cast<float>(main_projectile.y);
+    sf::Vector2f center = camera.getCenter();
+
+    if (x < view.position.x + margin_x)
+        center.x -= view.position.x + margin_x - x;
+    else if (x > view.position.x + view.size.x - margin_x)
+        center.x += x - (view.position.x + view.size.x - margin_x);
+    if (y < view.position.y + margin_y)
+        center.y -= view.position.y + margin_y - y;
+    else if (y > view.position.y + view.size.y - margin_y)
+        center.y += y - (view.position.y + view.size.y - margin_y);
+    place_camera(center.x, center.y);
 }
 
 // Main window processing handler
+// Passes an event on to ImGui, returns false once the window was closed
+bool process_event(const sf::Event &event){
+    // Send events to ImGui for GUI processing
+    ImGui::SFML::ProcessEvent(*window, event);
+
+    // Handle closing the SFML application
+    if (event.is<sf::Event::Closed>()){
+        window->close();
+        return false;
+    }
+
+    // The wheel zooms the scene unless it scrolls one of the windows
+    if (const auto *wheel = event.getIf<sf::Event::MouseWheelScrolled>()){
+        if (wheel->wheel == sf::Mouse::Wheel::Vertical && !ImGui::GetIO().WantCaptureMouse)
+            zoom_camera(wheel->delta > 0 ? 1 / ZOOM_STEP : ZOOM_STEP);
+    }
+    return true;
+}
+
 void window_processing(projectile_manager &main_projectile){
-    process_keyboard();
     static sf::Clock clock;
+    static int frames_to_draw {SETTLE_FRAMES};
+
+    // Idle: nothing moves, nothing is being solved or exported and the GUI has settled, so sleep until something happens
+    if (stop_time && !volley_flying && !gui_solver.busy() && !running_export.valid() && !running_sweep.valid() && !running_monte_carlo.valid() &&
+        !running_force_batch.valid() && frames_to_draw == 0){
+        const std::optional event = window->waitEvent(IDLE_WAIT);
+        if (!event)
+            return; // Nothing happened, the last frame is still on screen
+        if (!process_event(*event))
+            return;
+        frames_to_draw = SETTLE_FRAMES;
+        clock.restart(); // The time spent asleep is not part of the next frame
+    }
 
     // Poll and process all events
     while (const std::optional event = window->pollEvent()){
-        // Send events to ImGui for GUI processing
-        ImGui::SFML::ProcessEvent(*window, *event);
-
-        // Handle closing the SFML application
-        if (event->is<sf::Event::Closed>())
-            window->close();
+        if (!process_event(*event))
             return;
+        frames_to_draw = SETTLE_FRAMES;
     }
+    if (frames_to_draw > 0)
+        frames_to_draw--;
+
+    process_keyboard(main_projectile);
 
     // ImGUI Drawing
     // Update and re-draw the imGUI contents
-    ImGui::SFML::Update(*window, clock.restart());
+    const sf::Time frame_time = clock.restart();
+    frame_stats.frame_ms = frame_time.asSeconds() * 1000.f;
+    ImGui::SFML::Update(*window, frame_time);
+    collect_solution(main_projectile);
+    collect_export();
+    collect_sweep();
+    collect_monte_carlo();
+    collect_force_batch();
     render_gui(main_projectile);
+    render_sweep();
+    render_monte_carlo();
+    render_targeting(main_projectile);
+    render_volley();
+    render_obstacles(main_projectile);
 
     // SFML Drawing
     // Set the user view as the camera
     window->clear(sf::Color::Black);
-    follow_projectile = is_projectile_off_screen(main_projectile);
-    if (false){// to do, follow projectile when it leaves the bounds of the camera
-        double height = static_cast<float>(window->getSize().y);
-        camera.setCenter({main_projectile.x, height - main_projectile.y});
-    }
-    window->setView(camera);
 
     // Move
-    if (!stop_time)
-        main_projectile.move();
+    main_projectile.update(frame_time.asSeconds());
+    update_volley(main_projectile, frame_time.asSeconds());
+
+    if (follow_projectile)
+        follow_camera(main_projectile);
+    window->setView(camera);
 
     // Draw all objects
+    frame_stats.draw_calls = 0;
+    frame_stats.chunks_drawn = 0;
+    background_stripes.update(camera_rect(), window->getSize());
+    frame_stats.draw_calls += background_stripes.draw(*window);
     static_object_renderer.draw();
+    frame_stats.draw_calls += main_projectile.path.draw(*window);
+    if (target_arcs.getVertexCount() > 0){
+        window->draw(target_arcs);
+        frame_stats.draw_calls++;
+    }
+    frame_stats.draw_calls += volley_markers.draw(*window);
     dynamic_object_handler.draw();
 
     // Push the updates to both imGUI and SFML
@@ -771,17 +1512,6 @@ int main(){
     // Add objects to the frame
     projectile_manager main_projectile {};
 
-    // Draw some boxes in the bacground for scale
-    sf::Color color;
-    for (int x = 0; x < projectile_parameters[Parameter::RANGE].max * 100; x += 100) {
-        // Alternate colors: even stripes white, odd stripes black
-        if ((x/100) % 2 == 0){
-            color = sf::Color(43, 81, 134);
-            static_object_renderer.add_object(sf::RectangleShape({100.f, 1000.f}), color, Vector2(x, 0));
-        }   
-        // Dont need to draw black rectangle, background is already black so saves memory by not drawing unnecessary objects   
-    }
-
     // While the window is open, run the main processing loop
     while (window->isOpen()){
         window_processing(main_projectile);
@@ -0,0 +1,180 @@
+#include "monte_carlo.hpp"
+#include "batch_solver.hpp"
+#include "counter_rng.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+// Samples per task; the moments are merged block by block in a fixed order, so the block size (and not the
+// thread count) decides the rounding of the results
+const std::size_t SAMPLES_PER_BLOCK {65536}, SAMPLES_PER_BATCH {1024};
+
+// Running mean and variance (Welford), mergeable in any fixed order (Chan et al.)
+struct Moments{
+    std::size_t count {};
+    double mean {}, m2 {}, min {}, max {};
+
+    void add(double value){
+        count++;
+        const double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        min = count == 1 || value < min ? value : min;
+        max = count == 1 || value > max ? value : max;
+    }
+
+    void merge(const Moments &other){
+        if (other.count == 0)
+            return;
+        if (count == 0){
+            *this = other;
+            return;
+        }
+        const double total = static_cast<double>(count + other.count);
+        const double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        count += other.count;
+    }
+};
+
+// Input table of one sample
+void draw_sample(const ParameterValues &inputs, const InputDistributions &distributions, std::uint64_t seed,
+                 std::size_t sample, ParameterValues &table){
+    table = inputs;
+    for (std::size_t p = 0; p < PARAMETER_COUNT; p++){
+        const InputDistribution &distribution = distributions.value[p];
+        const counter_rng rng {seed, sample, static_cast<std::uint32_t>(p)};
+        if (distribution.kind == Distribution::NORMAL && inputs.value[p] != 0.0) // Unknowns have no value to spread around
+            table.value[p] = inputs.value[p] + distribution.sigma * rng.normal();
+        else if (distribution.kind == Distribution::UNIFORM)
+            table.value[p] = distribution.low + (distribution.high - distribution.low) * rng.uniform();
+    }
+    follow_launch_speed(inputs, table);
+}
+
+// Solves the samples [begin, end) batch by batch, calls solved(table) for every solved sample and
+// rejected(sample, check) for the others
+template <typename Solved, typename Rejected>
+void solve_samples(const ParameterValues &inputs, const InputDistributions &distributions, std::uint64_t seed,
+                   std::size_t begin, std::size_t end, Solved solved, Rejected rejected){
+    std::vector<ParameterValues> tables(SAMPLES_PER_BATCH);
+    std::vector<InputCheck> checks(SAMPLES_PER_BATCH);
+    ScenarioBatch scratch {};
+
+    for (std::size_t first = begin; first < end; first += SAMPLES_PER_BATCH){
+        const std::size_t count = std::min(SAMPLES_PER_BATCH, end - first);
+        for (std::size_t i = 0; i < count; i++)
+            draw_sample(inputs, distributions, seed, first + i, tables[i]);
+        cleanup_input_batch(tables.data(), checks.data(), count, scratch);
+
+        for (std::size_t i = 0; i < count; i++){
+            bool finite {true};
+            for (Parameter output : MONTE_CARLO_OUTPUTS)
+                finite = finite && std::isfinite(tables[i][output]);
+
+            if (checks[i].ok() && finite)
+                solved(tables[i]);
+            else
+                rejected(first + i, checks[i].ok() ? InputCheck{InputError::INCONSISTENT_VALUES} : checks[i]);
+        }
+    }
+}
+
+MonteCarloResult run_monte_carlo(const ParameterValues &inputs, const InputDistributions &distributions, const MonteCarloSettings &settings,
+                                 thread_pool &pool){
+    MonteCarloResult result {};
+    result.samples = settings.samples;
+    const std::size_t bins = std::max<std::size_t>(settings.bins, 1);
+
+    // First pass: moments and bounds of every output, one entry per block
+    struct BlockSummary{
+        Moments outputs[MONTE_CARLO_OUTPUT_COUNT] {};
+        std::size_t first_rejected {static_cast<std::size_t>(-1)};
+        InputCheck rejection {};
+    };
+    const std::size_t block_count = (settings.samples + SAMPLES_PER_BLOCK - 1) / SAMPLES_PER_BLOCK;
+    std::vector<BlockSummary> blocks(block_count);
+
+    pool.parallel_for(settings.samples, SAMPLES_PER_BLOCK, [&](std::size_t begin, std::size_t end){
+        BlockSummary &block = blocks[begin / SAMPLES_PER_BLOCK];
+        solve_samples(inputs, distributions, settings.seed, begin, end,
+            [&](const ParameterValues &table){
+                for (std::size_t o = 0; o < MONTE_CARLO_OUTPUT_COUNT; o++)
+                    block.outputs[o].add(table[MONTE_CARLO_OUTPUTS[o]]);
+            },
+            [&](std::size_t sample, const InputCheck &check){
+                if (sample < block.first_rejected){
+                    block.first_rejected = sample;
+                    block.rejection = check;
+                }
+            });
+    });
+
+    Moments totals[MONTE_CARLO_OUTPUT_COUNT] {};
+    std::size_t first_rejected {static_cast<std::size_t>(-1)};
+    for (const BlockSummary &block : blocks){
+        for (std::size_t o = 0; o < MONTE_CARLO_OUTPUT_COUNT; o++)
+            totals[o].merge(block.outputs[o]);
+        if (block.first_rejected < first_rejected){
+            first_rejected = block.first_rejected;
+            result.first_rejection = block.rejection;
+        }
+    }
+    result.solved = totals[0].count;
+    if (result.solved == 0)
+        return result;
+
+    // Second pass: the same samples again, counted into fine bins for the percentiles and coarse bins for display
+    // Counts add up the same in any order, so the blocks merge into shared histograms
+    std::vector<std::size_t> fine(MONTE_CARLO_OUTPUT_COUNT * MONTE_CARLO_FINE_BINS, 0), coarse(MONTE_CARLO_OUTPUT_COUNT * bins, 0);
+    double scale[MONTE_CARLO_OUTPUT_COUNT] {}; // Bins per unit of the output
+    for (std::size_t o = 0; o < MONTE_CARLO_OUTPUT_COUNT; o++)
+        scale[o] = totals[o].max > totals[o].min ? 1 / (totals[o].max - totals[o].min) : 0;
+    std::mutex merge_mutex {};
+
+    pool.parallel_for(settings.samples, SAMPLES_PER_BLOCK, [&](std::size_t begin, std::size_t end){
+        std::vector<std::size_t> block_fine(fine.size(), 0), block_coarse(coarse.size(), 0);
+        solve_samples(inputs, distributions, settings.seed, begin, end,
+            [&](const ParameterValues &table){
+                for (std::size_t o = 0; o < MONTE_CARLO_OUTPUT_COUNT; o++){
+                    const double position = (table[MONTE_CARLO_OUTPUTS[o]] - totals[o].min) * scale[o]; // In [0, 1]
+                    block_fine[o * MONTE_CARLO_FINE_BINS + std::min(static_cast<std::size_t>(position * MONTE_CARLO_FINE_BINS), MONTE_CARLO_FINE_BINS - 1)]++;
+                    block_coarse[o * bins + std::min(static_cast<std::size_t>(position * bins), bins - 1)]++;
+                }
+            },
+            [](std::size_t, const InputCheck &){});
+
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        for (std::size_t i = 0; i < fine.size(); i++)
+            fine[i] += block_fine[i];
+        for (std::size_t i = 0; i < coarse.size(); i++)
+            coarse[i] += block_coarse[i];
+    });
+
+    for (std::size_t o = 0; o < MONTE_CARLO_OUTPUT_COUNT; o++){
+        OutputDistribution &output = result.outputs[o];
+        const Moments &moments = totals[o];
+        output.mean = moments.mean;
+        output.stddev = moments.count > 1 ? std::sqrt(moments.m2 / (moments.count - 1)) : 0;
+        output.min = moments.min;
+        output.max = moments.max;
+        output.histogram.assign(coarse.begin() + static_cast<std::ptrdiff_t>(o * bins), coarse.begin() + static_cast<std::ptrdiff_t>((o + 1) * bins));
+
+        // Percentiles interpolated inside the fine bin they fall in
+        const std::size_t *counts = fine.data() + o * MONTE_CARLO_FINE_BINS;
+        const double bin_width = (moments.max - moments.min) / MONTE_CARLO_FINE_BINS;
+        for (std::size_t p = 0; p < MONTE_CARLO_PERCENTILE_COUNT; p++){
+            const double target = MONTE_CARLO_PERCENTILES[p] / 100 * moments.count;
+            double below {};
+            std::size_t bin {};
+            while (bin + 1 < MONTE_CARLO_FINE_BINS && below + counts[bin] < target)
+                below += counts[bin++];
+            const double inside = counts[bin] > 0 ? std::clamp((target - below) / counts[bin], 0.0, 1.0) : 0;
+            output.percentile[p] = moments.min + (bin + inside) * bin_width;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// Monte Carlo propagation of measurement uncertainty through the solver
+// Every sample draws its uncertain inputs from counter-based random streams keyed by (seed, sample, parameter),
+// so a run gives the same numbers for the same seed no matter how many threads take part
+//
+// The samples are generated twice instead of being stored: the first pass finds the moments and the bounds of
+// every output, the second fills the histograms between those bounds. Memory stays fixed for any sample count,
+// percentiles are read from a fine histogram and are exact to MONTE_CARLO_FINE_BINS-th of the output span
+#include "kinematics_core.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class Distribution {FIXED, NORMAL, UNIFORM};
+
+// How one input is drawn: FIXED keeps the table value, NORMAL uses the table value as mean (unknowns stay
+// unknown), UNIFORM ignores it
+struct InputDistribution{
+    Distribution kind {Distribution::FIXED};
+    double sigma {};         // NORMAL
+    double low {}, high {};  // UNIFORM
+};
+
+// Distribution of every parameter, indexed by Parameter
+struct InputDistributions{
+    InputDistribution value[PARAMETER_COUNT] {};
+
+    InputDistribution &operator[](Parameter parameter) { return value[static_cast<std::size_t>(parameter)]; }
+    const InputDistribution &operator[](Parameter parameter) const { return value[static_cast<std::size_t>(parameter)]; }
+};
+
+struct MonteCarloSettings{
+    std::size_t samples {100000};
+    std::uint64_t seed {1};
+    std::size_t bins {40}; // Histogram bins of every output
+};
+
+// Outputs that are reported, and the percentiles reported for each of them
+const std::size_t MONTE_CARLO_OUTPUT_COUNT {4}, MONTE_CARLO_PERCENTILE_COUNT {5};
+inline constexpr Parameter MONTE_CARLO_OUTPUTS[MONTE_CARLO_OUTPUT_COUNT] {Parameter::RANGE, Parameter::MAX_HEIGHT, Parameter::TIME, Parameter::TIME_OF_APEX};
+inline constexpr double MONTE_CARLO_PERCENTILES[MONTE_CARLO_PERCENTILE_COUNT] {5, 25, 50, 75, 95};
+const std::size_t MONTE_CARLO_FINE_BINS {16384};
+
+struct OutputDistribution{
+    double mean {}, stddev {}, min {}, max {};
+    double percentile[MONTE_CARLO_PERCENTILE_COUNT] {};
+    std::vector<std::size_t> histogram {}; // Even bins from min to max
+};
+
+struct MonteCarloResult{
+    std::size_t samples {}, solved {};
+    InputCheck first_rejection {}; // Why the first rejected sample was rejected, for the error message
+    OutputDistribution outputs[MONTE_CARLO_OUTPUT_COUNT] {};
+};
+
+// Solves `samples` draws of the input table, inputs without a distribution keep their value
+MonteCarloResult run_monte_carlo(const ParameterValues &inputs, const InputDistributions &distributions, const MonteCarloSettings &settings,
+                                 thread_pool &pool);
@@ -0,0 +1,63 @@
+#include "parameter_sweep.hpp"
+#include "batch_solver.hpp"
+#include <cmath>
+#include <limits>
+
+void sweep_cell(const ParameterValues &base, const SweepAxis &x, const SweepAxis &y, std::size_t column, std::size_t row, ParameterValues &parameters){
+    parameters = base;
+    parameters[y.parameter] = y.value_at(row);
+    parameters[x.parameter] = x.value_at(column); // x wins when both axes sweep the same parameter
+    follow_launch_speed(base, parameters); // Or every cell fails the speed check when both speeds are given
+}
+
+SweepResult run_sweep(const ParameterValues &base, const SweepAxis &x, const SweepAxis &y, Parameter objective, thread_pool &pool){
+    SweepResult result {};
+    result.width = x.steps;
+    result.height = y.steps;
+    result.values.assign(result.width * result.height, std::numeric_limits<double>::quiet_NaN());
+
+    // Rows only write their own entries, the totals are combined once all rows are done
+    std::vector<std::size_t> &row_best = result.row_best;
+    std::vector<std::size_t> row_solved(result.height, 0);
+    row_best.assign(result.height, SweepResult::NO_CELL);
+
+    pool.parallel_for(result.height, 1, [&](std::size_t begin, std::size_t end){
+        std::vector<ParameterValues> cells(result.width); // Input tables of one row
+        std::vector<InputCheck> checks(result.width);
+        ScenarioBatch scratch {};
+
+        for (std::size_t row = begin; row < end; row++){
+            for (std::size_t column = 0; column < result.width; column++)
+                sweep_cell(base, x, y, column, row, cells[column]);
+            cleanup_input_batch(cells.data(), checks.data(), result.width, scratch);
+
+            double *values = result.values.data() + row * result.width;
+            for (std::size_t column = 0; column < result.width; column++){
+                const double value = cells[column][objective];
+                if (!checks[column].ok() || !std::isfinite(value))
+                    continue;
+
+                values[column] = value;
+                row_solved[row]++;
+                if (row_best[row] == SweepResult::NO_CELL || value > values[row_best[row] - row * result.width])
+                    row_best[row] = row * result.width + column;
+            }
+        }
+    });
+
+    for (std::size_t row = 0; row < result.height; row++){
+        result.solved_cells += row_solved[row];
+        if (row_best[row] != SweepResult::NO_CELL && (!result.has_optimum() || result.values[row_best[row]] > result.values[result.best_cell]))
+            result.best_cell = row_best[row];
+    }
+
+    bool first {true};
+    for (double value : result.values){
+        if (std::isnan(value))
+            continue;
+        result.min_value = first || value < result.min_value ? value : result.min_value;
+        result.max_value = first || value > result.max_value ? value : result.max_value;
+        first = false;
+    }
+    return result;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// Parameter sweeps: one input table solved over a grid of values of one or two of its parameters
+// Every grid row is one task on the thread pool and its cells are solved together by cleanup_input_batch();
+// idle workers pick up the next unclaimed row, so rows that are cheap to solve never hold back the rest
+#include "kinematics_core.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <vector>
+
+// `steps` evenly spaced values of a parameter, from `from` to `to` inclusive
+struct SweepAxis{
+    Parameter parameter {Parameter::ANGLE};
+    double from {}, to {};
+    std::size_t steps {1};
+
+    double value_at(std::size_t i) const { return steps > 1 ? from + (to - from) * i / (steps - 1) : from; }
+};
+
+struct SweepResult{
+    static constexpr std::size_t NO_CELL {static_cast<std::size_t>(-1)};
+
+    std::size_t width {}, height {}; // Cells along the x and the y axis
+    std::vector<double> values {};   // Objective of every cell row by row, NaN where the cell has no solution
+    std::size_t solved_cells {};
+    std::size_t best_cell {NO_CELL}; // Cell with the largest objective
+    std::vector<std::size_t> row_best {}; // Envelope: best cell of every row, NO_CELL for rows without a solution
+    double min_value {}, max_value {}; // Over the solved cells
+
+    bool has_optimum() const { return best_cell != NO_CELL; }
+};
+
+// Input table of one cell, before solving
+void sweep_cell(const ParameterValues &base, const SweepAxis &x, const SweepAxis &y, std::size_t column, std::size_t row, ParameterValues &parameters);
+
+// Solves base with the x and y parameters replaced by every pair of grid values, and records the objective
+// A y axis of one step sweeps x alone
+SweepResult run_sweep(const ParameterValues &base, const SweepAxis &x, const SweepAxis &y, Parameter objective, thread_pool &pool);
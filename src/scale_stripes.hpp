@@ -0,0 +1,64 @@
+#pragma once
+
+// Background stripes that show the scale of the scene: a stripe every other `width` units from x = 0 to x = length
+// Only the stripes inside the view are generated, rebuilt when the view changes, so the cost does not grow with
+// the length of the scene. Zoomed far out, stripes narrower than a few pixels would only flicker, so groups of 2^k
+// stripes are merged into one stripe 2^k times as wide, keeping the left edges of the merged stripes in place
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+class scale_stripes{
+    private:
+        static constexpr float MIN_STRIPE_PIXELS {6.f}; // Narrowest stripe on screen before the next level of detail is used
+
+        const float width, length;
+        const sf::Color color;
+        sf::VertexArray vertices {sf::PrimitiveType::Triangles};
+        sf::FloatRect built_view {};
+        int built_level {-1};
+
+    public:
+        scale_stripes(float width, float length, sf::Color color): width(width), length(length), color(color) {}
+
+        // Level of detail for a view where one pixel covers units_per_pixel units: stripes are width * 2^level wide
+        int level_for(float units_per_pixel) const {
+            int level {};
+            while (width * static_cast<float>(1 << level) < MIN_STRIPE_PIXELS * units_per_pixel && level < 30)
+                level++;
+            return level;
+        }
+
+        // Regenerates the stripes inside view when the view changed, pixels is the size of the window
+        void update(const sf::FloatRect &view, const sf::Vector2u &pixels){
+            const int level = level_for(view.size.x / static_cast<float>(std::max(pixels.x, 1u)));
+            if (level == built_level && view.position.x == built_view.position.x && view.position.y == built_view.position.y &&
+                view.size.x == built_view.size.x && view.size.y == built_view.size.y)
+                return;
+            built_view = view;
+            built_level = level;
+
+            vertices.clear();
+            const float stripe = width * static_cast<float>(1 << level), period = 2 * stripe;
+            const float top = view.position.y, bottom = view.position.y + view.size.y;
+            const float right = std::min(view.position.x + view.size.x, length);
+            for (float left = std::max(std::floor(view.position.x / period), 0.f) * period; left < right; left += period){
+                const float end = std::min(left + stripe, length);
+                for (const sf::Vector2f &corner : {sf::Vector2f{left, top}, sf::Vector2f{end, top}, sf::Vector2f{end, bottom},
+                                                   sf::Vector2f{left, top}, sf::Vector2f{end, bottom}, sf::Vector2f{left, bottom}})
+                    vertices.append({corner, color});
+            }
+        }
+
+        int level() const { return built_level; }
+        std::size_t stripes() const { return vertices.getVertexCount() / 6; }
+
+        // Returns the number of draw calls issued
+        unsigned int draw(sf::RenderTarget &target) const {
+            if (vertices.getVertexCount() == 0)
+                return 0;
+            target.draw(vertices);
+            return 1;
+        }
+};
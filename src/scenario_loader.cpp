@@ -0,0 +1,212 @@
+#include "scenario_loader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define KINEMATICS_LOADER_MMAP
+#endif
+
+const std::size_t READ_BLOCK_BYTES {std::size_t{1} << 20};
+
+// Cuts up to max_lines rows off the front of text, skipping blank ones
+// A last row without line ending only counts once the input is complete; returns the bytes used up
+std::size_t take_lines(std::string_view text, bool complete, std::size_t max_lines, std::vector<std::string_view> &lines){
+    std::size_t start {};
+    while (lines.size() < max_lines && start < text.size()){
+        std::size_t end = text.find('\n', start);
+        if (end == std::string_view::npos){
+            if (!complete)
+                break;
+            end = text.size();
+        }
+
+        std::string_view line = text.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (!line.empty())
+            lines.push_back(line);
+        start = std::min(end + 1, text.size());
+    }
+    return start;
+}
+
+scenario_source::~scenario_source(){
+#if defined(KINEMATICS_LOADER_MMAP)
+    if (mapped != nullptr)
+        munmap(const_cast<char *>(mapped), mapped_size);
+#endif
+    if (owns_stream)
+        std::fclose(stream);
+}
+
+bool scenario_source::open(const std::string &path){
+    if (path == "-"){
+        stream = stdin;
+        return true;
+    }
+
+#if defined(KINEMATICS_LOADER_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0){
+        error = "Could not open input file: " + path;
+        return false;
+    }
+    struct stat info {};
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)){
+        mapped_size = static_cast<std::size_t>(info.st_size);
+        if (mapped_size == 0){
+            ::close(fd);
+            return true;
+        }
+        void *view = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED){
+            error = "Could not map input file: " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        mapped = static_cast<const char *>(view);
+        madvise(view, mapped_size, MADV_SEQUENTIAL);
+        return true;
+    }
+    ::close(fd); // Pipes and devices can not be mapped, they are read like stdin
+#endif
+
+    stream = std::fopen(path.c_str(), "rb");
+    owns_stream = stream != nullptr;
+    if (stream == nullptr)
+        error = "Could not open input file: " + path;
+    return stream != nullptr;
+}
+
+bool scenario_source::next_lines(std::size_t max_lines, std::vector<std::string_view> &lines){
+    lines.clear();
+    if (stream == nullptr){
+        // Rows point straight into the mapping
+        while (lines.empty() && position < mapped_size)
+            position += take_lines({mapped + position, mapped_size - position}, true, max_lines, lines);
+        return !lines.empty();
+    }
+
+    // The buffer only ever holds the rows of one call plus a partial row, so memory stays bounded
+    buffer.erase(0, consumed);
+    consumed = 0;
+    while (lines.empty()){
+        std::size_t newlines = static_cast<std::size_t>(std::count(buffer.begin(), buffer.end(), '\n'));
+        while (newlines < max_lines && !stream_done){
+            const std::size_t old_size = buffer.size();
+            buffer.resize(old_size + READ_BLOCK_BYTES);
+            const std::size_t read = std::fread(&buffer[old_size], 1, READ_BLOCK_BYTES, stream);
+            buffer.resize(old_size + read);
+            stream_done = read < READ_BLOCK_BYTES;
+            newlines += static_cast<std::size_t>(std::count(buffer.begin() + static_cast<std::ptrdiff_t>(old_size), buffer.end(), '\n'));
+        }
+
+        consumed = take_lines(buffer, stream_done, max_lines, lines);
+        if (lines.empty()){
+            if (stream_done)
+                return false;
+            buffer.erase(0, consumed); // Only blank rows so far
+            consumed = 0;
+        }
+    }
+    return true;
+}
+
+bool parse_header(std::string_view line, ScenarioHeader &header, std::string &error){
+    header.delimiter = line.find('\t') != std::string_view::npos ? '\t' : ',';
+    header.columns.clear();
+
+    std::size_t start {};
+    while (true){
+        const std::size_t end = std::min(line.find(header.delimiter, start), line.size());
+        const std::string_view column = line.substr(start, end - start);
+        auto found = std::find_if(std::begin(PARAMETER_INFO), std::end(PARAMETER_INFO),
+                                  [&](const ParameterInfo &info){ return column == info.name; });
+        if (found == std::end(PARAMETER_INFO)){
+            error = "Unknown parameter in header: '" + std::string{column} + "'";
+            return false;
+        }
+        header.columns.push_back(found->parameter);
+
+        if (end == line.size())
+            return true;
+        start = end + 1;
+    }
+}
+
+// Plain decimals ("-12.375") with at most 15 digits are exact as an integer over a power of ten, so one correctly
+// rounded division gives the same double as from_chars; anything else (exponents, long mantissas) goes to from_chars
+bool parse_number(std::string_view field, double &value){
+    static constexpr double POWERS_OF_TEN[] {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    const bool negative = field.front() == '-';
+    std::size_t i = negative ? 1 : 0, digits {}, decimals {};
+    std::uint64_t mantissa {};
+    bool point {false};
+    for (; i < field.size() && digits <= 15; i++){
+        const char c = field[i];
+        if (c >= '0' && c <= '9'){
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(c - '0');
+            digits++;
+            decimals += point ? 1 : 0;
+        }
+        else if (c == '.' && !point)
+            point = true;
+        else
+            break;
+    }
+    if (i == field.size() && digits > 0 && digits <= 15){
+        value = static_cast<double>(mantissa) / POWERS_OF_TEN[decimals];
+        value = negative ? -value : value;
+        return true;
+    }
+
+    const std::from_chars_result result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc{} && result.ptr == field.data() + field.size();
+}
+
+bool parse_scenario(std::string_view line, const ScenarioHeader &header, const ScenarioColumns &columns, std::size_t lane, std::string &error){
+    columns.reset(lane);
+
+    std::size_t start {};
+    for (Parameter column : header.columns){
+        const std::size_t end = std::min(line.find(header.delimiter, start), line.size());
+        std::string_view field = line.substr(start, end - start);
+
+        // Surrounding blanks and a leading plus are accepted like strtod does, from_chars takes neither
+        while (!field.empty() && (field.front() == ' ' || field.front() == '\t'))
+            field.remove_prefix(1);
+        while (!field.empty() && (field.back() == ' ' || field.back() == '\t'))
+            field.remove_suffix(1);
+        if (field.size() > 1 && field.front() == '+')
+            field.remove_prefix(1);
+
+        if (!field.empty()){ // Empty fields are unknowns
+            double value {};
+            if (!parse_number(field, value)){
+                error = "Could not parse value '" + std::string{line.substr(start, end - start)} + "' for parameter: " + parameter_info(column).name;
+                return false;
+            }
+            double *destination = columns.column(column);
+            if (destination == nullptr){
+                error = std::string{"Forces parameters can not be solved in a batch: "} + parameter_info(column).name;
+                return false;
+            }
+            destination[lane] = value;
+        }
+
+        if (end == line.size())
+            return true;
+        start = end + 1;
+    }
+
+    const std::size_t field_count = 1 + static_cast<std::size_t>(std::count(line.begin(), line.end(), header.delimiter));
+    error = "Row has " + std::to_string(field_count) + " fields but the header has " + std::to_string(header.columns.size());
+    return false;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// Loader for scenario files: a header row of ParameterInfo names, then one scenario per row
+// Files are memory-mapped and tokenized in place: rows are string_views into the mapping and numbers are parsed
+// with std::from_chars, so nothing is copied or allocated per row and rows can be parsed on any thread
+#include "batch_solver.hpp"
+#include "kinematics_core.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Input split into rows, chunk by chunk
+// Files are mapped read-only on POSIX systems; stdin and files elsewhere are read into a buffer that holds one chunk
+class scenario_source{
+    private:
+        const char *mapped {};
+        std::size_t mapped_size {}, position {};
+
+        std::FILE *stream {};
+        bool owns_stream {false}, stream_done {false};
+        std::string buffer {};
+        std::size_t consumed {}; // Bytes of buffer handed out by the last call
+
+        std::string error {};
+
+    public:
+        scenario_source() = default;
+        ~scenario_source();
+        scenario_source(const scenario_source &) = delete;
+        scenario_source &operator=(const scenario_source &) = delete;
+
+        // '-' reads stdin
+        bool open(const std::string &path);
+
+        // Replaces lines with up to max_lines non-empty rows, without their line endings
+        // The views stay valid until the next call; returns false once the input is exhausted
+        bool next_lines(std::size_t max_lines, std::vector<std::string_view> &lines);
+
+        const std::string &last_error() const { return error; }
+};
+
+// Column layout of a scenario file
+struct ScenarioHeader{
+    char delimiter {','}; // Tab when the header has one, comma otherwise
+    std::vector<Parameter> columns {};
+};
+
+// Maps every column name of the header row to its parameter
+bool parse_header(std::string_view line, ScenarioHeader &header, std::string &error);
+
+// Parses one row straight into a lane of the columns, empty fields are unknowns
+// Ranges are left to check_input(); the forces parameters have no column and must be left empty
+// error is only written when the row is rejected, the values parsed so far are kept
+bool parse_scenario(std::string_view line, const ScenarioHeader &header, const ScenarioColumns &columns, std::size_t lane, std::string &error);
@@ -0,0 +1,99 @@
+#pragma once
+
+// Packs many shapes into one triangle list per material (texture), so each material is drawn with a single call
+// Vertex colors carry the fill colors, so plain colored shapes of any color share one material
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+class shape_batch{
+    private:
+        struct material_batch{
+            const sf::Texture *texture {};
+            std::vector<sf::Vertex> vertices {};
+            sf::VertexBuffer buffer {sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static};
+        };
+
+        std::vector<material_batch> batches {};
+        bool use_buffers {sf::VertexBuffer::isAvailable()}; // Falls back to drawing straight from memory without GPU buffers
+
+        material_batch &batch_for(const sf::Texture *texture){
+            for (material_batch &batch : batches){
+                if (batch.texture == texture)
+                    return batch;
+            }
+            batches.push_back(material_batch{texture});
+            return batches.back();
+        }
+
+    public:
+        // Drops every shape but keeps the memory for the next rebuild
+        void clear(){
+            for (material_batch &batch : batches)
+                batch.vertices.clear();
+        }
+
+        // Appends the fill of a convex shape as a triangle fan split into triangles, outlines are not batched
+        void add(const sf::Shape &shape){
+            const std::size_t point_count = shape.getPointCount();
+            if (point_count < 3)
+                return;
+
+            material_batch &batch = batch_for(shape.getTexture());
+            const sf::Transform &transform = shape.getTransform();
+            const sf::FloatRect bounds = shape.getLocalBounds();
+            const sf::IntRect texture_rect = shape.getTextureRect();
+            const sf::Color color = shape.getFillColor();
+
+            auto vertex = [&](std::size_t index){
+                const sf::Vector2f point = shape.getPoint(index);
+                const float u = bounds.size.x > 0 ? (point.x - bounds.position.x) / bounds.size.x : 0.f;
+                const float v = bounds.size.y > 0 ? (point.y - bounds.position.y) / bounds.size.y : 0.f;
+                return sf::Vertex{transform.transformPoint(point), color,
+                                  {texture_rect.position.x + texture_rect.size.x * u, texture_rect.position.y + texture_rect.size.y * v}};
+            };
+
+            const sf::Vertex first = vertex(0);
+            sf::Vertex previous = vertex(1);
+            for (std::size_t i = 2; i < point_count; i++){
+                const sf::Vertex next = vertex(i);
+                batch.vertices.push_back(first);
+                batch.vertices.push_back(previous);
+                batch.vertices.push_back(next);
+                previous = next;
+            }
+        }
+
+        // Sends the vertices to the GPU, call once after a rebuild
+        void upload(){
+            if (!use_buffers)
+                return;
+
+            for (material_batch &batch : batches){
+                if (batch.vertices.empty())
+                    continue;
+                if (batch.buffer.getVertexCount() != batch.vertices.size() && !batch.buffer.create(batch.vertices.size())){
+                    use_buffers = false;
+                    return;
+                }
+                batch.buffer.update(batch.vertices.data());
+            }
+        }
+
+        // Returns the number of draw calls issued
+        unsigned int draw(sf::RenderTarget &target) const {
+            unsigned int draw_calls {};
+            for (const material_batch &batch : batches){
+                if (batch.vertices.empty())
+                    continue;
+
+                sf::RenderStates states {batch.texture};
+                if (use_buffers)
+                    target.draw(batch.buffer, 0, batch.vertices.size(), states);
+                else
+                    target.draw(batch.vertices.data(), batch.vertices.size(), sf::PrimitiveType::Triangles, states);
+                draw_calls++;
+            }
+            return draw_calls;
+        }
+};
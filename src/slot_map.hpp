@@ -0,0 +1,98 @@
+#pragma once
+
+// Generational slot map: O(1) insert and erase, handles that stay valid while their object lives,
+// and objects packed densely for iteration
+// Erasing bumps the generation of the slot, so handles to erased objects are detected instead of
+// silently pointing at whatever reused the slot
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct slot_handle{
+    static constexpr std::uint32_t NO_SLOT {0xffffffffu};
+
+    std::uint32_t index {NO_SLOT};
+    std::uint32_t generation {};
+
+    bool is_valid() const { return index != NO_SLOT; }
+};
+
+template <typename T>
+class slot_map{
+    private:
+        struct slot{
+            std::uint32_t dense {};      // Position in objects while used, next free slot while free
+            std::uint32_t generation {};
+        };
+
+        std::vector<T> objects {};             // Dense, in no particular order
+        std::vector<std::uint32_t> owners {};  // Slot of every dense object
+        std::vector<slot> slots {};
+        std::uint32_t free_head {slot_handle::NO_SLOT};
+
+    public:
+        slot_handle insert(T object){
+            std::uint32_t index {};
+            if (free_head != slot_handle::NO_SLOT){
+                index = free_head;
+                free_head = slots[index].dense;
+            }
+            else{
+                index = static_cast<std::uint32_t>(slots.size());
+                slots.push_back(slot{});
+            }
+
+            slots[index].dense = static_cast<std::uint32_t>(objects.size());
+            objects.push_back(std::move(object));
+            owners.push_back(index);
+            return {index, slots[index].generation};
+        }
+
+        bool contains(slot_handle handle) const {
+            return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+        }
+
+        T *get(slot_handle handle){
+            return contains(handle) ? &objects[slots[handle.index].dense] : nullptr;
+        }
+
+        // Moves the last object into the hole, so the objects stay dense; returns false for stale handles
+        bool erase(slot_handle handle){
+            if (!contains(handle))
+                return false;
+
+            const std::uint32_t dense = slots[handle.index].dense;
+            const std::uint32_t last = static_cast<std::uint32_t>(objects.size() - 1);
+            if (dense != last){
+                objects[dense] = std::move(objects[last]);
+                owners[dense] = owners[last];
+                slots[owners[dense]].dense = dense;
+            }
+            objects.pop_back();
+            owners.pop_back();
+
+            slots[handle.index].generation++;
+            slots[handle.index].dense = free_head;
+            free_head = handle.index;
+            return true;
+        }
+
+        void clear(){
+            for (std::uint32_t index : owners){
+                slots[index].generation++;
+                slots[index].dense = free_head;
+                free_head = index;
+            }
+            objects.clear();
+            owners.clear();
+        }
+
+        std::size_t size() const { return objects.size(); }
+
+        // Dense iteration, erasing while iterating invalidates the iterators
+        typename std::vector<T>::iterator begin() { return objects.begin(); }
+        typename std::vector<T>::iterator end() { return objects.end(); }
+        typename std::vector<T>::const_iterator begin() const { return objects.begin(); }
+        typename std::vector<T>::const_iterator end() const { return objects.end(); }
+};
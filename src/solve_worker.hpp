@@ -0,0 +1,136 @@
+#pragma once
+
+// Background thread that validates and solves scenarios for the GUI, so the render loop never waits on the physics engine
+// Requests and results travel through lock-free single-producer/single-consumer queues; only the newest request
+// is ever solved, older ones are cancelled before (or after) they run
+#include "kinematics_core.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Snapshot of the input table taken when the request was made, never touched by the GUI afterwards
+struct SolveRequest{
+    std::uint64_t id {};
+    ParameterValues parameters {};
+};
+
+struct SolveResult{
+    std::uint64_t id {};
+    ParameterValues parameters {}; // Solved table (or the snapshot as far as it got if check failed)
+    InputCheck check {};
+};
+
+class solve_worker{
+    private:
+        static constexpr std::size_t QUEUE_CAPACITY {8};
+
+        spsc_queue<SolveRequest, QUEUE_CAPACITY> requests {}; // GUI -> worker
+        spsc_queue<SolveResult, QUEUE_CAPACITY> results {};   // worker -> GUI
+
+        // Id of the newest request, anything older is stale
+        std::atomic<std::uint64_t> latest_request {0};
+        std::atomic<bool> stopping {false};
+
+        // Only used to let the worker sleep while there is nothing to do, the queues themselves never lock
+        std::mutex sleep_mutex {};
+        std::condition_variable wake {};
+
+        // GUI thread state
+        std::uint64_t next_id {0}, waiting_for {0}; // waiting_for is 0 when no result is expected
+        SolveRequest overflow {};                   // Request that did not fit into a full queue, resent by poll()
+        bool has_overflow {false};
+
+        std::thread worker {};
+
+        void notify_worker(){
+            // Taking the lock once makes sure the worker is either waiting or about to look at the queue
+            { std::lock_guard<std::mutex> lock(sleep_mutex); }
+            wake.notify_one();
+        }
+
+        void worker_loop(){
+            SolveRequest request {};
+            SolveResult result {};
+            while (true){
+                {
+                    std::unique_lock<std::mutex> lock(sleep_mutex);
+                    wake.wait(lock, [&]{ return stopping.load() || !requests.empty(); });
+                }
+                if (stopping)
+                    return;
+
+                // Drain the queue, only the newest request is worth solving
+                while (requests.try_pop(request)) {}
+                if (request.id != latest_request.load(std::memory_order_acquire))
+                    continue;
+
+                result.id = request.id;
+                result.parameters = request.parameters;
+                result.check = cleanup_input(result.parameters);
+
+                // A newer request came in while solving, nobody wants this result anymore
+                if (result.id != latest_request.load(std::memory_order_acquire))
+                    continue;
+
+                // The GUI drains the results every frame, so a full queue only lasts until the next frame
+                while (!results.try_push(result)){
+                    if (stopping)
+                        return;
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    public:
+        solve_worker(): worker(&solve_worker::worker_loop, this) {}
+
+        ~solve_worker(){
+            stopping = true;
+            notify_worker();
+            worker.join();
+        }
+
+        solve_worker(const solve_worker &) = delete;
+        solve_worker &operator=(const solve_worker &) = delete;
+
+        // GUI thread: queues a snapshot of the table and cancels every older request
+        void submit(const ParameterValues &parameters){
+            waiting_for = ++next_id;
+            latest_request.store(waiting_for, std::memory_order_release);
+
+            SolveRequest request {waiting_for, parameters};
+            has_overflow = !requests.try_push(request);
+            if (has_overflow)
+                overflow = request;
+            notify_worker();
+        }
+
+        // GUI thread: drops whatever is pending or being solved
+        void cancel(){
+            latest_request.store(++next_id, std::memory_order_release);
+            waiting_for = 0;
+            has_overflow = false;
+        }
+
+        // GUI thread: true when a request was made and its result has not been picked up yet
+        bool busy() const { return waiting_for != 0; }
+
+        // GUI thread: returns true and fills result once the newest request is solved, result is only valid then
+        bool poll(SolveResult &result){
+            if (has_overflow && requests.try_push(overflow)){
+                has_overflow = false;
+                notify_worker();
+            }
+
+            while (results.try_pop(result)){
+                if (result.id == waiting_for){
+                    waiting_for = 0;
+                    return true;
+                }
+            }
+            return false;
+        }
+};
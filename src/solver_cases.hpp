@@ -0,0 +1,152 @@
+#pragma once
+
+// The 20 cases of the symmetric (y_initial = 0) projectile solver, shared by find_unknown() and the batch kernels.
+// A case is picked by which of the six solvable quantities are unknown (zero), encoded as a bitmask, so the
+// case lookup is a single table load instead of a chain of comparisons.
+//
+// Everything is inside an anonymous namespace: the batch kernels instantiate these templates in a translation
+// unit built with -mavx2, and that build must never be shared with the scalar translation units.
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+enum UnknownBit : unsigned {UNKNOWN_V_INITIAL = 1, UNKNOWN_V_FINAL = 2, UNKNOWN_ACC = 4, UNKNOWN_TIME = 8, UNKNOWN_MAX_HEIGHT = 16, UNKNOWN_RANGE = 32};
+const unsigned UNKNOWN_MASKS {64};
+const int CASE_COUNT {21}; // 20 cases plus "no case applies" (0)
+
+// Unknowns solved by every case, in the order of the original if/else chain
+// When more than three quantities are unknown several cases match, the first one in this list wins
+constexpr unsigned CASE_UNKNOWNS[CASE_COUNT] {
+    0,
+    UNKNOWN_TIME | UNKNOWN_MAX_HEIGHT | UNKNOWN_RANGE,    // 1
+    UNKNOWN_TIME | UNKNOWN_ACC | UNKNOWN_RANGE,           // 2
+    UNKNOWN_ACC | UNKNOWN_V_INITIAL | UNKNOWN_RANGE,      // 3
+    UNKNOWN_V_FINAL | UNKNOWN_ACC | UNKNOWN_RANGE,        // 4
+    UNKNOWN_V_FINAL | UNKNOWN_TIME | UNKNOWN_RANGE,       // 5
+    UNKNOWN_V_INITIAL | UNKNOWN_TIME | UNKNOWN_RANGE,     // 6
+    UNKNOWN_MAX_HEIGHT | UNKNOWN_ACC | UNKNOWN_RANGE,     // 7
+    UNKNOWN_V_INITIAL | UNKNOWN_RANGE | UNKNOWN_MAX_HEIGHT,   // 8
+    UNKNOWN_RANGE | UNKNOWN_V_FINAL | UNKNOWN_MAX_HEIGHT,     // 9
+    UNKNOWN_V_FINAL | UNKNOWN_V_INITIAL | UNKNOWN_RANGE,      // 10
+    UNKNOWN_MAX_HEIGHT | UNKNOWN_TIME | UNKNOWN_V_INITIAL,    // 11
+    UNKNOWN_MAX_HEIGHT | UNKNOWN_TIME | UNKNOWN_V_FINAL,      // 12
+    UNKNOWN_MAX_HEIGHT | UNKNOWN_TIME | UNKNOWN_ACC,          // 13
+    UNKNOWN_MAX_HEIGHT | UNKNOWN_V_INITIAL | UNKNOWN_V_FINAL, // 14
+    UNKNOWN_MAX_HEIGHT | UNKNOWN_V_INITIAL | UNKNOWN_ACC,     // 15
+    UNKNOWN_MAX_HEIGHT | UNKNOWN_V_FINAL | UNKNOWN_ACC,       // 16
+    UNKNOWN_TIME | UNKNOWN_V_INITIAL | UNKNOWN_V_FINAL,       // 17
+    UNKNOWN_TIME | UNKNOWN_V_INITIAL | UNKNOWN_ACC,           // 18
+    UNKNOWN_TIME | UNKNOWN_V_FINAL | UNKNOWN_ACC,             // 19
+    UNKNOWN_V_INITIAL | UNKNOWN_V_FINAL | UNKNOWN_ACC         // 20
+};
+
+// Case that solves the given set of unknowns, 0 if none does
+constexpr int case_of_unknowns(unsigned unknown){
+    for (int k = 1; k < CASE_COUNT; k++){
+        if ((unknown & CASE_UNKNOWNS[k]) == CASE_UNKNOWNS[k])
+            return k;
+    }
+    return 0;
+}
+
+struct case_lookup{
+    std::uint8_t case_of[UNKNOWN_MASKS];
+
+    constexpr case_lookup(): case_of{} {
+        for (unsigned unknown = 0; unknown < UNKNOWN_MASKS; unknown++)
+            case_of[unknown] = static_cast<std::uint8_t>(case_of_unknowns(unknown));
+    }
+};
+constexpr case_lookup CASE_LOOKUP {};
+
+// Broadcasts a constant into T, T is either double or one of the SIMD packs of the batch kernels
+template <typename T>
+T splat(double x) { return T::set(x); }
+template <>
+double splat<double>(double x) { return x; }
+
+// Values one case reads and writes, sin/cos of the launch angle are computed by the caller
+template <typename T>
+struct case_values{
+    T v_initial, v_final, acc, time, max_height, range, sin_theta, cos_theta;
+};
+
+// Solves the unknowns of one case from the three known values
+// The expressions follow the original if/else chain operation by operation; pow(x, 2) is written as x * x
+// and x / 2 as x * 0.5, which are exact and give bit-identical results
+template <int CASE, typename T>
+void solve_case(case_values<T> &l){
+    const T zero = splat<T>(0.0), half = splat<T>(0.5), two = splat<T>(2.0);
+    auto halve = [&](T x){ return x * half; };
+    auto sq = [](T x){ return x * x; };
+    auto full_time = [&]{ return (((zero - l.v_initial) * l.sin_theta) / l.acc) * two; };
+    auto acc_from_time = [&]{ return ((zero - l.v_initial) * l.sin_theta) / halve(l.time); };
+    auto range_from_time = [&]{ return l.v_initial * l.cos_theta * l.time; };
+    auto time_from_range = [&]{ return l.range / (l.v_initial * l.cos_theta); };
+    auto apex_height = [&]{ return (l.v_initial * l.sin_theta * halve(l.time)) + (half * l.acc * sq(halve(l.time))); };
+    auto full_height = [&]{ return (l.v_initial * l.sin_theta * l.time) + (half * l.acc * sq(l.time)); };
+
+    // 1. time & max_height & range
+    if constexpr (CASE == 1){ l.time = full_time(); l.max_height = apex_height(); l.range = range_from_time(); }
+    // 2. time & acc & range
+    else if constexpr (CASE == 2){ l.acc = (zero - sq(l.v_initial * l.sin_theta)) / (two * l.max_height); l.time = full_time(); l.range = range_from_time(); }
+    // 3. acc & v_initial & range
+    else if constexpr (CASE == 3){ l.v_initial = l.v_final; l.acc = acc_from_time(); l.range = range_from_time(); }
+    // 4. v_final & acc & range
+    else if constexpr (CASE == 4){ l.v_final = l.v_initial; l.acc = acc_from_time(); l.range = range_from_time(); }
+    // 5. v_final & time & range
+    else if constexpr (CASE == 5){ l.v_final = l.v_initial; l.time = ((zero - l.v_initial) * l.sin_theta) / halve(l.acc); l.range = range_from_time(); }
+    // 6. v_initial & time & range
+    else if constexpr (CASE == 6){ l.v_initial = l.v_final; l.time = full_time(); l.range = range_from_time(); }
+    // 7. max_height & acc & range
+    else if constexpr (CASE == 7){ l.acc = acc_from_time(); l.max_height = -sq(splat<T>(5.0) * l.sin_theta) / l.acc; l.range = range_from_time(); }
+    // 8. v_initial & range & max_height
+    else if constexpr (CASE == 8){ l.v_initial = l.v_final; l.time = time_from_range(); l.max_height = apex_height(); }
+    // 9. range & v_final & max_height
+    else if constexpr (CASE == 9){ l.v_final = l.v_initial; l.range = range_from_time(); l.max_height = apex_height(); }
+    // 10. v_final & v_initial & range
+    else if constexpr (CASE == 10){
+        l.v_initial = (l.max_height - half * l.acc * sq(halve(l.time))) / (halve(l.time) * l.sin_theta);
+        l.v_final = l.v_initial; l.range = range_from_time();
+    }
+    // 11. max_height & time & v_initial
+    else if constexpr (CASE == 11){ l.v_initial = l.v_final; l.time = full_time(); l.max_height = full_height(); }
+    // 12. max_height & time & v_final
+    else if constexpr (CASE == 12){ l.v_final = l.v_initial; l.time = ((((zero - l.v_initial) * l.sin_theta) * two) / l.acc) * two; l.max_height = full_height(); }
+    // 13. max_height & time & acc
+    else if constexpr (CASE == 13){ l.time = time_from_range(); l.acc = acc_from_time(); l.max_height = full_height(); }
+    // 14. max_height & v_initial & v_final
+    else if constexpr (CASE == 14){ l.v_initial = l.range / (l.time * l.cos_theta); l.v_final = l.v_initial; l.max_height = full_height(); }
+    // 15. max_height & v_initial & acc
+    else if constexpr (CASE == 15){ l.v_initial = l.v_final; l.acc = acc_from_time(); l.max_height = full_height(); }
+    // 16. max_height & v_final & acc
+    else if constexpr (CASE == 16){ l.v_final = l.v_initial; l.acc = acc_from_time(); l.max_height = full_height(); }
+    // 17. time & v_initial & v_final
+    else if constexpr (CASE == 17){ l.time = zero; l.v_initial = zero; l.v_final = zero; }
+    // 18. time & v_initial & acc
+    else if constexpr (CASE == 18){ l.v_initial = l.v_final; l.time = time_from_range(); l.acc = acc_from_time(); }
+    // 19. time & v_final & acc
+    else if constexpr (CASE == 19){ l.v_final = l.v_initial; l.time = time_from_range(); l.acc = acc_from_time(); }
+    // 20. v_initial & v_final & acc
+    else if constexpr (CASE == 20){ l.v_initial = l.range / (l.time * l.cos_theta); l.v_final = l.v_initial; l.acc = acc_from_time(); }
+}
+
+// Scalar solver for every set of unknowns, nullptr where no case applies
+using case_solver = void (*)(case_values<double> &);
+
+struct case_dispatch{
+    case_solver solver[UNKNOWN_MASKS];
+};
+
+template <int... CASES>
+constexpr case_dispatch make_case_dispatch(std::integer_sequence<int, CASES...>){
+    constexpr case_solver by_case[CASE_COUNT] {nullptr, &solve_case<CASES + 1, double>...};
+    case_dispatch dispatch {};
+    for (unsigned unknown = 0; unknown < UNKNOWN_MASKS; unknown++)
+        dispatch.solver[unknown] = by_case[CASE_LOOKUP.case_of[unknown]];
+    return dispatch;
+}
+constexpr case_dispatch CASE_DISPATCH = make_case_dispatch(std::make_integer_sequence<int, CASE_COUNT - 1>{});
+
+} // namespace
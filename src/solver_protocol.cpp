@@ -0,0 +1,105 @@
+#include "solver_protocol.hpp"
+#include <cstring>
+
+template <typename T>
+void append_value(std::vector<char> &out, T value){
+    const std::size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+template <typename T>
+T read_value(const char *&data){
+    T value {};
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return value;
+}
+
+// Size of the body of the frame at the start of data, false while the header itself is incomplete
+bool frame_body(const char *data, std::size_t size, std::uint32_t &body){
+    if (size < FRAME_HEADER_BYTES)
+        return false;
+    std::memcpy(&body, data, sizeof(body));
+    return true;
+}
+
+void append_request(std::vector<char> &out, std::uint32_t id, const ParameterValues &parameters){
+    std::uint8_t pairs {};
+    for (std::size_t i = 0; i < PARAMETER_COUNT; i++)
+        pairs += parameters.value[i] != PARAMETER_INFO[i].default_value;
+
+    append_value<std::uint32_t>(out, static_cast<std::uint32_t>(4 + 1 + pairs * REQUEST_PAIR_BYTES));
+    append_value<std::uint32_t>(out, id);
+    append_value<std::uint8_t>(out, pairs);
+    for (std::size_t i = 0; i < PARAMETER_COUNT; i++){
+        if (parameters.value[i] == PARAMETER_INFO[i].default_value)
+            continue;
+        append_value<std::uint8_t>(out, static_cast<std::uint8_t>(i));
+        append_value<double>(out, parameters.value[i]);
+    }
+}
+
+void append_response(std::vector<char> &out, const SolverResponse &response){
+    append_value<std::uint32_t>(out, static_cast<std::uint32_t>(RESPONSE_BODY));
+    append_value<std::uint32_t>(out, response.id);
+    append_value<std::uint8_t>(out, static_cast<std::uint8_t>(response.check.error));
+    append_value<std::uint8_t>(out, static_cast<std::uint8_t>(response.check.parameter));
+    append_value<std::uint8_t>(out, static_cast<std::uint8_t>(response.check.dependency));
+    append_value<std::uint8_t>(out, static_cast<std::uint8_t>(response.check.scalar_count));
+    append_value<std::uint8_t>(out, static_cast<std::uint8_t>(response.check.vector_count));
+    append_value<double>(out, response.check.value);
+    for (double value : response.parameters.value)
+        append_value<double>(out, value);
+}
+
+FrameStatus read_request(const char *data, std::size_t size, SolverRequest &request, std::size_t &consumed){
+    std::uint32_t body {};
+    if (!frame_body(data, size, body))
+        return FrameStatus::INCOMPLETE;
+    if (body < 5 || body > MAX_REQUEST_BODY || (body - 5) % REQUEST_PAIR_BYTES != 0)
+        return FrameStatus::MALFORMED;
+    if (size < FRAME_HEADER_BYTES + body)
+        return FrameStatus::INCOMPLETE;
+
+    const char *at = data + FRAME_HEADER_BYTES;
+    request.id = read_value<std::uint32_t>(at);
+    const std::uint8_t pairs = read_value<std::uint8_t>(at);
+    if (pairs != (body - 5) / REQUEST_PAIR_BYTES)
+        return FrameStatus::MALFORMED;
+
+    request.parameters.reset();
+    ParameterMask listed {};
+    for (std::uint8_t pair = 0; pair < pairs; pair++){
+        const std::uint8_t parameter = read_value<std::uint8_t>(at);
+        if (parameter >= PARAMETER_COUNT || (listed & parameter_bit(static_cast<Parameter>(parameter))))
+            return FrameStatus::MALFORMED;
+        listed |= parameter_bit(static_cast<Parameter>(parameter));
+        request.parameters.value[parameter] = read_value<double>(at);
+    }
+    consumed = FRAME_HEADER_BYTES + body;
+    return FrameStatus::COMPLETE;
+}
+
+FrameStatus read_response(const char *data, std::size_t size, SolverResponse &response, std::size_t &consumed){
+    std::uint32_t body {};
+    if (!frame_body(data, size, body))
+        return FrameStatus::INCOMPLETE;
+    if (body != RESPONSE_BODY)
+        return FrameStatus::MALFORMED;
+    if (size < FRAME_HEADER_BYTES + body)
+        return FrameStatus::INCOMPLETE;
+
+    const char *at = data + FRAME_HEADER_BYTES;
+    response.id = read_value<std::uint32_t>(at);
+    response.check.error = static_cast<InputError>(read_value<std::uint8_t>(at));
+    response.check.parameter = static_cast<Parameter>(read_value<std::uint8_t>(at));
+    response.check.dependency = static_cast<Parameter>(read_value<std::uint8_t>(at));
+    response.check.scalar_count = read_value<std::uint8_t>(at);
+    response.check.vector_count = read_value<std::uint8_t>(at);
+    response.check.value = read_value<double>(at);
+    for (double &value : response.parameters.value)
+        value = read_value<double>(at);
+    consumed = FRAME_HEADER_BYTES + body;
+    return FrameStatus::COMPLETE;
+}
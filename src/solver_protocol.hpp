@@ -0,0 +1,44 @@
+#pragma once
+
+// Binary wire format between the solver daemon (kinematics_daemon) and its clients
+// Every message is a frame: a uint32 with the size of the body, then the body. Values are stored in host byte order
+// like the columnar exports, so both ends have to be little endian.
+//
+//   request body    uint32 request id, uint8 pair count, pair count x {uint8 Parameter, double value}
+//                   Parameters that are not listed keep their default value, so a request only carries the inputs
+//   response body   uint32 request id, uint8 InputError, uint8 parameter, uint8 dependency, uint8 scalar count,
+//                   uint8 vector count, double value (the InputCheck of the table), PARAMETER_COUNT doubles
+//                   (the solved table, or the table as it was sent when the check failed)
+// Responses of one connection may come back in any order, the request id tells them apart
+#include "kinematics_core.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+const std::size_t FRAME_HEADER_BYTES {4};
+const std::size_t REQUEST_PAIR_BYTES {1 + 8};
+const std::size_t MAX_REQUEST_BODY {4 + 1 + PARAMETER_COUNT * REQUEST_PAIR_BYTES};
+const std::size_t RESPONSE_BODY {4 + 5 + 8 + PARAMETER_COUNT * 8};
+
+struct SolverRequest{
+    std::uint32_t id {};
+    ParameterValues parameters {};
+};
+
+struct SolverResponse{
+    std::uint32_t id {};
+    InputCheck check {};
+    ParameterValues parameters {};
+};
+
+// COMPLETE: one frame was decoded; INCOMPLETE: more bytes are needed; MALFORMED: the stream can not be trusted anymore
+enum class FrameStatus {COMPLETE, INCOMPLETE, MALFORMED};
+
+// Appends the frame of a request with every parameter that differs from its default value
+void append_request(std::vector<char> &out, std::uint32_t id, const ParameterValues &parameters);
+void append_response(std::vector<char> &out, const SolverResponse &response);
+
+// Decodes the frame at the start of data, consumed receives the size of a complete frame
+// A request that lists a parameter twice or one that does not exist is malformed
+FrameStatus read_request(const char *data, std::size_t size, SolverRequest &request, std::size_t &consumed);
+FrameStatus read_response(const char *data, std::size_t size, SolverResponse &response, std::size_t &consumed);
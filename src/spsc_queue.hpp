@@ -0,0 +1,46 @@
+#pragma once
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread
+#include <atomic>
+#include <cstddef>
+
+template <typename T, std::size_t CAPACITY>
+class spsc_queue{
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "spsc_queue capacity must be a power of two");
+
+    private:
+        T slots[CAPACITY] {};
+
+        // Both counters only ever grow, the slot of a position is position % CAPACITY
+        // They sit on their own cache lines so the two threads do not fight over one line
+        alignas(64) std::atomic<std::size_t> head {0}; // Next position to pop, written by the consumer
+        alignas(64) std::atomic<std::size_t> tail {0}; // Next position to push, written by the producer
+
+    public:
+        // Producer only, returns false when the queue is full
+        bool try_push(const T &item){
+            const std::size_t position = tail.load(std::memory_order_relaxed);
+            if (position - head.load(std::memory_order_acquire) == CAPACITY)
+                return false;
+
+            slots[position & (CAPACITY - 1)] = item;
+            tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only, returns false when the queue is empty
+        bool try_pop(T &item){
+            const std::size_t position = head.load(std::memory_order_relaxed);
+            if (tail.load(std::memory_order_acquire) == position)
+                return false;
+
+            item = slots[position & (CAPACITY - 1)];
+            head.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only
+        bool empty() const {
+            return tail.load(std::memory_order_acquire) == head.load(std::memory_order_relaxed);
+        }
+};
@@ -0,0 +1,102 @@
+#include "targeting.hpp"
+#include "targeting_kernels.hpp"
+#include <cmath>
+
+#if defined(KINEMATICS_HAVE_AVX2_KERNEL)
+// Compiled with AVX2 enabled in batch_solver_avx2.cpp, only called after the CPU check
+void solve_targets_avx2(const TargetingProblem &problem, const TargetColumns &columns);
+#endif
+
+const int TARGET_NEWTON_STEPS {16};
+
+void TargetBatch::resize(std::size_t count){
+    x.resize(count);
+    y.resize(count);
+    for (std::size_t arc = 0; arc < ARC_COUNT; arc++){
+        angle[arc].resize(count);
+        speed[arc].resize(count);
+        time[arc].resize(count);
+    }
+    refined.resize(count);
+}
+
+TargetColumns TargetBatch::columns(){
+    TargetColumns c {size(), x.data(), y.data()};
+    for (std::size_t arc = 0; arc < ARC_COUNT; arc++){
+        c.angle[arc] = angle[arc].data();
+        c.speed[arc] = speed[arc].data();
+        c.time[arc] = time[arc].data();
+    }
+    c.refined = refined.data();
+    return c;
+}
+
+// Writes one arc of target i from tan(angle)
+void store_arc(const TargetColumns &c, std::size_t i, std::size_t arc, double tangent, double speed){
+    c.angle[arc][i] = std::atan(tangent) * (180.0 / M_PI);
+    c.speed[arc][i] = speed;
+    c.time[arc][i] = c.x[i] * std::sqrt(1 + tangent * tangent) / speed;
+}
+
+// Fixes a target the closed form flagged: on the edge of the reachable region both arcs are the double root
+// (rounding can push the discriminant either way), elsewhere every arc gets Newton steps on
+// f(u) = x u - k (1 + u^2) - dy with u = tan(angle)
+void refine_target(const TargetingProblem &problem, const TargetColumns &c, std::size_t i){
+    const double g = -problem.acc, v2 = problem.speed * problem.speed;
+    const double x = c.x[i], dy = c.y[i] - problem.y_initial;
+    const double k = g * x * x / (2 * v2);
+    const double discriminant = v2 * v2 - g * (g * x * x + 2 * dy * v2);
+
+    if (std::fabs(discriminant) <= v2 * v2 * TARGET_EDGE_TOLERANCE){
+        const double vertex = x / (2 * k); // Where f'(u) = 0
+        for (std::size_t arc = 0; arc < ARC_COUNT; arc++)
+            store_arc(c, i, arc, vertex, problem.speed);
+        return;
+    }
+
+    for (std::size_t arc = 0; arc < ARC_COUNT; arc++){
+        double u = std::tan(c.angle[arc][i] * (M_PI / 180.0));
+        for (int step = 0; step < TARGET_NEWTON_STEPS; step++){
+            const double residual = x * u - k * (1 + u * u) - dy, slope = x - 2 * k * u;
+            const double scale = std::fabs(x * u) + k * (1 + u * u) + std::fabs(dy);
+            if (std::fabs(residual) <= scale * (TARGET_RESIDUAL_TOLERANCE / 16) || slope == 0)
+                break;
+            u -= residual / slope;
+        }
+        store_arc(c, i, arc, u, problem.speed);
+    }
+}
+
+std::size_t solve_targets(const TargetingProblem &problem, const TargetColumns &targets, BatchKernel kernel){
+    if (kernel == BatchKernel::AVX2 && best_batch_kernel() != BatchKernel::AVX2)
+        kernel = best_batch_kernel();
+
+    switch (kernel){
+#if defined(KINEMATICS_HAVE_AVX2_KERNEL)
+        case BatchKernel::AVX2:
+            solve_targets_avx2(problem, targets);
+            break;
+#endif
+#if defined(__SSE2__)
+        case BatchKernel::SSE2:
+            solve_target_columns<pack_sse2>(problem, targets);
+            break;
+#endif
+        default:
+            solve_target_columns<pack_scalar>(problem, targets);
+            break;
+    }
+
+    std::size_t refined {};
+    for (std::size_t i = 0; i < targets.count; i++){
+        if (!targets.refined[i])
+            continue;
+        refine_target(problem, targets, i);
+        refined++;
+    }
+    return refined;
+}
+
+std::size_t solve_targets(const TargetingProblem &problem, TargetBatch &targets, BatchKernel kernel){
+    return solve_targets(problem, targets.columns(), kernel);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Inverse targeting: the launch angle or speed that makes the projectile pass through given target points
+// The projectile starts at (0, y_initial) and targets are measured from the ground below the launch point, so
+// launches from a height need no special case here
+//
+// With a fixed speed every reachable target is hit on two arcs, a low and a high one, which merge into one on
+// the edge of the reachable region; with a fixed angle there is at most one speed. The closed-form solutions
+// run on the SIMD packs of find_unknown_batch(), lanes that come out inaccurate (next to the edge, where the
+// two roots cancel) are refined with Newton's method on the trajectory equation
+#include "batch_solver.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class TargetConstraint {FIXED_SPEED, FIXED_ANGLE};
+
+struct TargetingProblem{
+    TargetConstraint constraint {TargetConstraint::FIXED_SPEED};
+    double speed {}; // FIXED_SPEED
+    double angle {}; // FIXED_ANGLE, degrees
+    double acc {-9.81};
+    double y_initial {};
+};
+
+const std::size_t LOW_ARC {0}, HIGH_ARC {1}, ARC_COUNT {2};
+
+// Non-owning view over the columns of a target batch, like ScenarioColumns
+struct TargetColumns{
+    std::size_t count {};
+    const double *x {}, *y {};
+    double *angle[ARC_COUNT] {}, *speed[ARC_COUNT] {}, *time[ARC_COUNT] {}; // Outputs
+    std::uint8_t *refined {}; // 1 where the closed form was not accurate enough on its own
+};
+
+// Targets and their solutions
+// Every arc holds NaN where it does not reach the target; a fixed angle only fills the low arc
+struct TargetBatch{
+    std::vector<double> x {}, y {};
+    std::vector<double> angle[ARC_COUNT] {}, speed[ARC_COUNT] {}, time[ARC_COUNT] {};
+    std::vector<std::uint8_t> refined {};
+
+    void resize(std::size_t count);
+    std::size_t size() const { return x.size(); }
+    TargetColumns columns();
+};
+
+// Solves every target in place, returns the number of targets that were refined
+std::size_t solve_targets(const TargetingProblem &problem, const TargetColumns &targets, BatchKernel kernel = best_batch_kernel());
+std::size_t solve_targets(const TargetingProblem &problem, TargetBatch &targets, BatchKernel kernel = best_batch_kernel());
@@ -0,0 +1,118 @@
+#pragma once
+
+// Closed-form targeting kernels behind solve_targets(), written against the packs of batch_kernels.hpp
+// targeting.cpp instantiates them for scalar and SSE2, batch_solver_avx2.cpp for AVX2
+#include "batch_kernels.hpp"
+#include "targeting.hpp"
+#include <limits>
+
+namespace {
+
+// atan for every lane, Cephes' reduction and rational approximation (within 1 ULP of libm)
+template <typename P>
+P pack_atan(P t){
+    const P zero = P::set(0.0), one = P::set(1.0);
+    const P negative = greater(zero, t);
+    const P a = abs(t);
+
+    // tan(3 pi / 8) and 0.66 split the argument into three ranges, each reduced to |z| <= 0.66
+    const P big = greater(a, P::set(2.41421356237309504880)), middle = greater(a, P::set(0.66));
+    const P base = select(big, P::set(M_PI / 2), select(middle, P::set(M_PI / 4), zero));
+    const P more_bits = select(big, P::set(6.123233995736765886130e-17), select(middle, P::set(3.061616997868382943065e-17), zero));
+    const P z = select(big, -(one / a), select(middle, (a - one) / (a + one), a));
+
+    const P zz = z * z;
+    const P p = (((P::set(-8.750608600031904122785e-1) * zz + P::set(-1.615753718733365076637e1)) * zz + P::set(-7.500855792314704667340e1)) * zz +
+                 P::set(-1.228866684490136173410e2)) * zz + P::set(-6.485021904942025371773e1);
+    const P q = ((((zz + P::set(2.485846490142306297962e1)) * zz + P::set(1.650270098316988542046e2)) * zz + P::set(4.328810604912902668951e2)) * zz +
+                 P::set(4.853903996359136964868e2)) * zz + P::set(1.945506571482613964425e2);
+    const P result = base + (more_bits + (z * (zz * p / q) + z));
+    return negate_if(negative, result);
+}
+
+// Relative residual above which a lane goes to Newton's method, and the band of the discriminant (relative to
+// v^4) in which a target counts as lying on the edge of the reachable region
+const double TARGET_RESIDUAL_TOLERANCE {1e-12}, TARGET_EDGE_TOLERANCE {1e-12};
+
+// Marks the lanes of mask in the refined column
+template <typename P>
+void store_refined(P mask, std::uint8_t *refined){
+    const int zero = zero_lanes(mask);
+    for (std::size_t k = 0; k < P::width; k++)
+        refined[k] = !(zero >> k & 1);
+}
+
+// Both arcs through every target for a fixed speed
+// tan(angle) solves the trajectory equation x tan - g x^2 (1 + tan^2) / (2 v^2) = dy, a quadratic in tan; the
+// low root is taken from the product of the roots so it does not cancel
+template <typename P>
+void solve_fixed_speed(const TargetingProblem &problem, const TargetColumns &c, std::size_t i){
+    const P zero = P::set(0.0), one = P::set(1.0), not_a_number = P::set(std::numeric_limits<double>::quiet_NaN());
+    const P g = P::set(-problem.acc), v = P::set(problem.speed), v2 = P::set(problem.speed * problem.speed);
+    const P x = P::load(c.x + i), dy = P::load(c.y + i) - P::set(problem.y_initial);
+
+    const P gx2 = g * x * x;
+    const P discriminant = v2 * v2 - g * (gx2 + P::set(2.0) * dy * v2);
+    const P reachable = mask_and(greater(x, zero), mask_and(greater(discriminant, zero), greater(v, zero)));
+    const P sum = v2 + sqrt(select(reachable, discriminant, zero));
+
+    const P tangent[ARC_COUNT] {(gx2 + P::set(2.0) * dy * v2) / (x * sum), sum / (g * x)};
+    const P k = gx2 / (P::set(2.0) * v2);
+    const P edge = v2 * v2 * P::set(TARGET_EDGE_TOLERANCE);
+    P refine = mask_and(greater(x, zero), mask_and(greater(edge, discriminant), greater(discriminant, -edge)));
+    for (std::size_t arc = 0; arc < ARC_COUNT; arc++){
+        const P u = tangent[arc], lift = k * (one + u * u);
+        const P residual = x * u - lift - dy, scale = abs(x * u) + lift + abs(dy);
+        refine = select(refine, refine, mask_and(reachable, greater(abs(residual), scale * P::set(TARGET_RESIDUAL_TOLERANCE))));
+    }
+    store_refined(refine, c.refined + i);
+
+    for (std::size_t arc = 0; arc < ARC_COUNT; arc++){
+        const P degrees = pack_atan(tangent[arc]) * P::set(180.0 / M_PI);
+        const P time = x * sqrt(one + tangent[arc] * tangent[arc]) / v;
+        select(reachable, degrees, not_a_number).store(c.angle[arc] + i);
+        select(reachable, v, not_a_number).store(c.speed[arc] + i);
+        select(reachable, time, not_a_number).store(c.time[arc] + i);
+    }
+}
+
+// The one speed through every target for a fixed angle: v^2 = g x^2 (1 + tan^2) / (2 (x tan - dy))
+template <typename P>
+void solve_fixed_angle(const TargetingProblem &problem, const TargetColumns &c, std::size_t i, double tangent, double cosine){
+    const P zero = P::set(0.0), not_a_number = P::set(std::numeric_limits<double>::quiet_NaN());
+    const P g = P::set(-problem.acc), t = P::set(tangent);
+    const P x = P::load(c.x + i), dy = P::load(c.y + i) - P::set(problem.y_initial);
+
+    const P rise = x * t - dy; // Height the straight line gains over the target, gravity has to take it back
+    const P reachable = mask_and(greater(x, zero), greater(rise, zero));
+    const P speed = sqrt(g * x * x * P::set(1 + tangent * tangent) / (P::set(2.0) * select(reachable, rise, P::set(1.0))));
+    select(reachable, P::set(problem.angle), not_a_number).store(c.angle[LOW_ARC] + i);
+    select(reachable, speed, not_a_number).store(c.speed[LOW_ARC] + i);
+    select(reachable, x / (speed * P::set(cosine)), not_a_number).store(c.time[LOW_ARC] + i);
+    for (double *column : {c.angle[HIGH_ARC], c.speed[HIGH_ARC], c.time[HIGH_ARC]})
+        not_a_number.store(column + i);
+    store_refined(zero, c.refined + i);
+}
+
+// Entry point for one instruction set, closed form only
+template <typename P>
+void solve_target_columns(const TargetingProblem &problem, const TargetColumns &c){
+    constexpr std::size_t W = P::width;
+    const std::size_t packed = c.count - c.count % W;
+    const double radians = problem.angle * (M_PI / 180.0);
+    const double tangent = std::tan(radians), cosine = std::cos(radians);
+
+    auto solve = [&](auto pack_tag, std::size_t i){
+        using Q = decltype(pack_tag);
+        if (problem.constraint == TargetConstraint::FIXED_SPEED)
+            solve_fixed_speed<Q>(problem, c, i);
+        else
+            solve_fixed_angle<Q>(problem, c, i, tangent, cosine);
+    };
+    for (std::size_t i = 0; i < packed; i += W)
+        solve(P{}, i);
+    for (std::size_t i = packed; i < c.count; i++)
+        solve(pack_scalar{}, i);
+}
+
+} // namespace
@@ -0,0 +1,115 @@
+#pragma once
+
+// Fixed size pool of worker threads used by the headless batch paths
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class thread_pool{
+    private:
+        std::vector<std::thread> workers {};
+        std::mutex mutex {};
+        std::condition_variable job_ready {}, job_done {};
+
+        // Current job: the range [0, count) is handed out block by block
+        std::function<void(std::size_t, std::size_t)> job {};
+        std::atomic<std::size_t> next_block {0};
+        std::size_t count {}, block_size {1}, block_count {};
+        unsigned int generation {}, busy_workers {};
+        bool stopping {false};
+
+        // Claims blocks of the current job until none are left
+        // The job fields are passed in as copied under the lock, a new job only rewrites them once busy_workers is 0
+        void run_blocks(std::size_t total, std::size_t size, std::size_t blocks){
+            for (std::size_t block = next_block++; block < blocks; block = next_block++){
+                std::size_t begin = block * size;
+                job(begin, std::min(begin + size, total));
+            }
+        }
+
+        void worker_loop(){
+            unsigned int seen_generation {};
+            while (true){
+                std::size_t total {}, size {}, blocks {};
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    job_ready.wait(lock, [&]{ return stopping || generation != seen_generation; });
+                    if (stopping)
+                        return;
+                    seen_generation = generation;
+                    // Woke up after every block was claimed, parallel_for may already have returned
+                    if (next_block >= block_count)
+                        continue;
+                    total = count;
+                    size = block_size;
+                    blocks = block_count;
+                    busy_workers++;
+                }
+
+                run_blocks(total, size, blocks);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--busy_workers == 0)
+                    job_done.notify_all();
+            }
+        }
+
+    public:
+        // A thread count of 0 uses one worker per hardware thread
+        explicit thread_pool(unsigned int thread_count = 0){
+            if (thread_count == 0)
+                thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+            // The calling thread also works on every job, so it counts as one of the workers
+            for (unsigned int i = 1; i < thread_count; i++)
+                workers.emplace_back(&thread_pool::worker_loop, this);
+        }
+
+        ~thread_pool(){
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            job_ready.notify_all();
+            for (std::thread &worker : workers)
+                worker.join();
+        }
+
+        thread_pool(const thread_pool &) = delete;
+        thread_pool &operator=(const thread_pool &) = delete;
+
+        unsigned int size() const {
+            return static_cast<unsigned int>(workers.size()) + 1;
+        }
+
+        // Calls fn(begin, end) over [0, total) split into blocks of at most grain items
+        // Blocks until every block has been processed
+        void parallel_for(std::size_t total, std::size_t grain, const std::function<void(std::size_t, std::size_t)> &fn){
+            if (total == 0)
+                return;
+
+            std::size_t size {}, blocks {};
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = fn;
+                count = total;
+                block_size = size = std::max<std::size_t>(1, grain);
+                block_count = blocks = (total + block_size - 1) / block_size;
+                next_block = 0;
+                generation++;
+            }
+            job_ready.notify_all();
+
+            run_blocks(total, size, blocks);
+
+            // Wait for the workers that picked up this job to drain
+            std::unique_lock<std::mutex> lock(mutex);
+            job_done.wait(lock, [&]{ return busy_workers == 0; });
+            job = nullptr;
+        }
+};
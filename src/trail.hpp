@@ -0,0 +1,102 @@
+#pragma once
+
+// Trajectory trail with bounded memory and draw cost
+// Points live in a fixed-capacity buffer mirrored by a GPU vertex buffer: new points are appended to the
+// vertex buffer one by one, and only when the capacity is reached is the older half thinned out where the
+// path is (almost) straight and the vertex buffer rewritten once
+#include <SFML/Graphics.hpp>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+class trail{
+    private:
+        const std::size_t capacity;
+        const float tolerance; // Largest distance (px) between a dropped point and the thinned out path
+        const sf::Color color;
+
+        std::vector<sf::Vertex> points {}; // Oldest first, never holds more than capacity points
+        sf::VertexBuffer buffer {sf::PrimitiveType::LineStrip, sf::VertexBuffer::Usage::Dynamic};
+        bool use_buffer {sf::VertexBuffer::isAvailable()}; // Falls back to drawing straight from memory without GPU buffers
+        std::size_t uploaded {0};                         // Points already copied into buffer
+
+        // Distance of p from the line through a and b
+        static float distance_to_line(sf::Vector2f a, sf::Vector2f b, sf::Vector2f p){
+            const float dx = b.x - a.x, dy = b.y - a.y;
+            const float length = std::sqrt(dx * dx + dy * dy);
+            if (length == 0.f)
+                return std::sqrt((p.x - a.x) * (p.x - a.x) + (p.y - a.y) * (p.y - a.y));
+            return std::abs(dy * (p.x - a.x) - dx * (p.y - a.y)) / length;
+        }
+
+        // Makes room for at least a quarter of the capacity, the newer half keeps every point
+        void decimate(){
+            const std::size_t older = points.size() / 2;
+
+            // Keep the points of the older half where the path bends more than the tolerance
+            std::size_t kept {1};
+            for (std::size_t i = 1; i < older; i++){
+                if (distance_to_line(points[kept - 1].position, points[i + 1].position, points[i].position) > tolerance)
+                    points[kept++] = points[i];
+            }
+            for (std::size_t i = older; i < points.size(); i++)
+                points[kept++] = points[i];
+            points.resize(kept);
+
+            // A path that bends everywhere can not be thinned out enough, the oldest points go instead
+            const std::size_t limit = capacity - capacity / 4;
+            if (points.size() > limit)
+                points.erase(points.begin(), points.begin() + static_cast<std::ptrdiff_t>(points.size() - limit));
+
+            uploaded = 0;
+        }
+
+    public:
+        explicit trail(std::size_t capacity = 4096, sf::Color color = sf::Color::White, float tolerance = 0.5f):
+            capacity(capacity < 8 ? 8 : capacity), tolerance(tolerance), color(color) {
+            points.reserve(this->capacity);
+        }
+
+        void push(sf::Vector2f position){
+            if (points.size() == capacity)
+                decimate();
+            points.push_back(sf::Vertex{position, color});
+        }
+
+        // Moves the newest point, such as the tip of a path that is still growing
+        void move_last(sf::Vector2f position){
+            if (points.empty())
+                return;
+            points.back().position = position;
+            if (uploaded == points.size())
+                uploaded--;
+        }
+
+        void clear(){
+            points.clear();
+            uploaded = 0;
+        }
+
+        std::size_t size() const { return points.size(); }
+
+        // Uploads the points added since the last call and draws the whole trail, returns the number of draw calls
+        unsigned int draw(sf::RenderTarget &target){
+            if (points.size() < 2)
+                return 0;
+
+            if (use_buffer && buffer.getVertexCount() != capacity && !buffer.create(capacity))
+                use_buffer = false;
+
+            if (!use_buffer){
+                target.draw(points.data(), points.size(), sf::PrimitiveType::LineStrip);
+                return 1;
+            }
+
+            if (uploaded < points.size()){
+                buffer.update(points.data() + uploaded, points.size() - uploaded, static_cast<unsigned int>(uploaded));
+                uploaded = points.size();
+            }
+            target.draw(buffer, 0, points.size());
+            return 1;
+        }
+};
@@ -0,0 +1,77 @@
+#include "trajectory.hpp"
+#include <algorithm>
+#include <cmath>
+
+const int INTEGRATED_PIECES {8}; // Pieces integrated motion starts with, it can fold back on itself within a single piece
+const int MAX_SPLIT {256};        // Pieces one span is split into at most
+const int MAX_DEPTH {24};         // Splits of one span before it is accepted as it is
+const double STEP_SAFETY {0.9};   // Pieces slightly shorter than the curvature allows, so most pass their check
+
+struct path_point{
+    double x, y;
+};
+
+path_point point_at(const Trajectory &trajectory, double time){
+    return {trajectory.x_at(time), trajectory.y_at(time)};
+}
+
+// Distance of p from the segment from a to b
+double distance_to_segment(path_point a, path_point b, path_point p){
+    const double dx = b.x - a.x, dy = b.y - a.y, length_squared = dx * dx + dy * dy;
+    double along = length_squared > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / length_squared : 0;
+    along = along < 0 ? 0 : (along > 1 ? 1 : along);
+    return std::hypot(p.x - (a.x + along * dx), p.y - (a.y + along * dy));
+}
+
+// Longest piece starting at time whose chord stays within tolerance: a chord of h seconds is off by a_perp h^2 / 8,
+// with a_perp the acceleration across the direction of motion (the curvature times the squared speed)
+// Velocity and acceleration come from three positions h apart, exact for a parabola and close for integrated motion
+double curvature_step(const Trajectory &trajectory, double time, double h, double tolerance){
+    const path_point p0 = point_at(trajectory, time), p1 = point_at(trajectory, time + h), p2 = point_at(trajectory, time + 2 * h);
+    const double vx = (-3 * p0.x + 4 * p1.x - p2.x) / (2 * h), vy = (-3 * p0.y + 4 * p1.y - p2.y) / (2 * h);
+    const double ax = (p2.x - 2 * p1.x + p0.x) / (h * h), ay = (p2.y - 2 * p1.y + p0.y) / (h * h);
+    const double speed = std::hypot(vx, vy), across = speed > 0 ? std::abs(ax * vy - ay * vx) / speed : std::hypot(ax, ay);
+    return across > 0 ? STEP_SAFETY * std::sqrt(8 * tolerance / across) : HUGE_VAL;
+}
+
+// Appends the end times of the pieces of [from, to] in order, from itself is already in the list
+// A span whose point halfway in time is off its chord by more than tolerance is split into pieces as long as the
+// local curvature allows, and each piece is checked the same way
+void subdivide(const Trajectory &trajectory, double from, path_point start, double to, path_point end, double tolerance, int depth,
+               std::vector<double> &times){
+    const double error = distance_to_segment(start, end, point_at(trajectory, 0.5 * (from + to)));
+    if (depth >= MAX_DEPTH || !(error > tolerance)){
+        times.push_back(to);
+        return;
+    }
+
+    const double span = to - from, shortest = span / MAX_SPLIT;
+    const double halving = 0.5 * span; // The error check alone would halve the span
+    double time = from;
+    while (time < to){
+        double step = std::min(std::max(curvature_step(trajectory, time, shortest / 4, tolerance), shortest), halving);
+        if (time + 1.25 * step >= to) // No sliver at the end
+            step = to - time;
+        const double next = time + step;
+        const path_point point = next >= to ? end : point_at(trajectory, next);
+        subdivide(trajectory, time, start, next >= to ? to : next, point, tolerance, depth + 1, times);
+        time = next;
+        start = point;
+    }
+}
+
+void sample_polyline(const Trajectory &trajectory, double from, double to, double tolerance, std::vector<double> &times){
+    times.push_back(from);
+    if (!(to > from))
+        return;
+
+    // A parabola is farthest from its chord halfway in time, one span is enough to start with
+    const int pieces = trajectory.integrated ? INTEGRATED_PIECES : 1;
+    path_point start = point_at(trajectory, from);
+    for (int piece = 1; piece <= pieces; piece++){
+        const double time = piece == pieces ? to : from + (to - from) * piece / pieces;
+        const path_point end = point_at(trajectory, time);
+        subdivide(trajectory, times.back(), start, time, end, tolerance, 0, times);
+        start = end;
+    }
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+// Closed-form playback of a solved launch
+// The position at any time comes straight from the launch values, so seeking anywhere costs the same as one
+// step and nothing has to be replayed or stored. Motion integrated by the forces engine is played back the same
+// way through its dense output
+#include "collision.hpp"
+#include "forces.hpp"
+#include "kinematics_core.hpp"
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Positions are in metres, x from the launch point and y from the ground below it; the screen origin is only
+// applied when drawing
+struct Trajectory{
+    double x0 {}, y0 {}, vx {}, vy {}, acc {};
+    double end_time {}; // Time the projectile is back down at y = 0, 0 when it never comes down
+    std::shared_ptr<const ForceTrajectory> integrated {}; // Replaces the launch values when set, shared so copies stay cheap
+
+    double x_at(double t) const { return integrated ? x0 + integrated->state_at(t).x : x0 + (vx * t); }
+    double y_at(double t) const { return integrated ? y0 + integrated->state_at(t).y : y0 + (vy * t + 0.5 * acc * (t * t)); }
+    double vx_at(double t) const { return integrated ? integrated->state_at(t).vx : vx; }
+    double vy_at(double t) const { return integrated ? integrated->state_at(t).vy : vy + acc * t; }
+};
+
+// Launch of the solved table, from the height y_initial
+inline Trajectory make_trajectory(const ParameterValues &parameters){
+    Trajectory trajectory {0, parameters[Parameter::Y_INITIAL]};
+    const double angle_rad = parameters[Parameter::ANGLE] * (M_PI / 180);
+
+    if (parameters[Parameter::INITIAL_SPEED] != 0){
+        trajectory.vx = parameters[Parameter::INITIAL_SPEED] * std::cos(angle_rad);
+        trajectory.vy = parameters[Parameter::INITIAL_SPEED] * std::sin(angle_rad);
+    }
+    else{
+        trajectory.vx = parameters[Parameter::V_INITIAL_I_COMPONENT];
+        trajectory.vy = parameters[Parameter::V_INITIAL_J_COMPONENT];
+    }
+    trajectory.acc = parameters[Parameter::ACC];
+
+    // Later root of y0 + vy t + acc t^2 / 2 = 0, the flight time the table was solved for; only a downwards
+    // acceleration brings it back
+    const double y0 = trajectory.y0;
+    if (trajectory.acc < 0)
+        trajectory.end_time = (-trajectory.vy - std::sqrt(trajectory.vy * trajectory.vy - 2 * trajectory.acc * y0)) / trajectory.acc;
+    return trajectory;
+}
+
+// Motion of the forces engine, which starts at the height of its body
+inline Trajectory make_trajectory(std::shared_ptr<const ForceTrajectory> integrated){
+    Trajectory trajectory {};
+    trajectory.end_time = integrated->end_time();
+    trajectory.integrated = std::move(integrated);
+    return trajectory;
+}
+
+// Ends a launch where it first enters one of the obstacles; the obstacles have their own frame, in which the
+// launch point (x = 0 on the ground) is at (origin_x, origin_y)
+// Only closed-form launches are cut, integrated motion is not a parabola and keeps its own end
+inline ObstacleHit clip_to_obstacles(Trajectory &trajectory, const obstacle_grid &obstacles, double origin_x, double origin_y){
+    if (trajectory.integrated || trajectory.end_time <= 0)
+        return {};
+    const ObstacleHit hit = obstacles.first_hit({origin_x + trajectory.x0, origin_y + trajectory.y0, trajectory.vx, trajectory.vy, 0, trajectory.acc},
+                                                trajectory.end_time);
+    if (hit.hit)
+        trajectory.end_time = hit.time;
+    return hit;
+}
+
+// Appends to times the fewest points in time, from `from` to `to` in order, whose straight polyline stays within
+// tolerance of the path. Spans are halved until the point halfway in time is within tolerance of the chord; on a
+// parabola that point is the farthest from the chord, so the bound is exact for closed-form launches. The points
+// crowd around the apex, where the path bends, and thin out where it is nearly straight
+void sample_polyline(const Trajectory &trajectory, double from, double to, double tolerance, std::vector<double> &times);
+
+// Turns real elapsed time into a whole number of fixed simulation steps
+// The simulation only ever moves by whole steps, so its state depends on the number of steps taken and
+// never on the frame rate; the leftover fraction is only used to interpolate what is drawn
+class fixed_step_clock{
+    private:
+        const double step_seconds;
+        const int max_steps; // Steps per call before the backlog is dropped, a long hitch must not stall the next frames
+        double accumulator {};
+
+    public:
+        explicit fixed_step_clock(double step_seconds, int max_steps = 8): step_seconds(step_seconds), max_steps(max_steps) {}
+
+        // Adds real time, returns the number of steps that are due
+        int accumulate(double real_seconds){
+            accumulator += real_seconds;
+            int steps = static_cast<int>(accumulator / step_seconds);
+            if (steps > max_steps){
+                steps = max_steps;
+                accumulator = 0;
+            }
+            else
+                accumulator -= steps * step_seconds;
+            return steps;
+        }
+
+        // How far the next step has come, in [0, 1)
+        double alpha() const { return accumulator / step_seconds; }
+
+        void reset() { accumulator = 0; }
+};
+
+// Playback position inside [0, end], moved step by step while playing or set directly by seeking
+class playback_clock{
+    private:
+        double time {}, end {}, speed {1};
+
+    public:
+        // Starts over at t = 0 for a flight that lasts end_time
+        void reset(double end_time){
+            end = end_time > 0 ? end_time : 0;
+            time = 0;
+        }
+
+        // Jumps to any time of the flight, O(1) like every other move
+        void seek(double t){
+            time = t < 0 ? 0 : (t > end ? end : t);
+        }
+
+        // Moves by `steps` steps of step_seconds, negative steps go back
+        void step(int steps, double step_seconds){
+            seek(time + steps * step_seconds);
+        }
+
+        // Playback speed scales how much real time passes per step, the steps themselves never change
+        void set_speed(double new_speed) { speed = new_speed; }
+
+        double get_time() const { return time; }
+        double get_end() const { return end; }
+        double get_speed() const { return speed; }
+        bool at_end() const { return time >= end; }
+};
+
+// Trail behind a playing projectile: the polyline of sample_polyline() from launch up to the playback time
+// Points up to the last bend are final, the newest one is a tip that follows the projectile until the path bends
+// away from the line to it
+class trail_polyline{
+    private:
+        double final_time {};
+        bool tip {false};
+        std::vector<double> times {};
+
+    public:
+        // Starts over at the launch point, which is the first point of every trail
+        void reset(){
+            final_time = 0;
+            tip = false;
+        }
+
+        // Calls add(time, replaces_tip) for every point from the last call up to time; replaces_tip asks to move
+        // the newest point instead of adding one
+        template <typename Add>
+        void extend(const Trajectory &trajectory, double time, double tolerance, Add add){
+            times.clear();
+            sample_polyline(trajectory, final_time, time, tolerance, times);
+            for (std::size_t i = 1; i < times.size(); i++)
+                add(times[i], i == 1 && tip);
+            if (times.size() > 2)
+                final_time = times[times.size() - 2];
+            if (times.size() > 1)
+                tip = true;
+        }
+};
+
+// Playback of a trajectory in fixed simulation steps without a window: what the simulator does every frame, minus
+// the drawing. Frames of any length can be fed in, or every remaining step run at once, as fast as possible
+// The run only depends on the steps taken, so the same trajectory ends with the same trail at any frame rate
+class fixed_step_run{
+    public:
+        struct TrailPoint{
+            double time, x, y;
+        };
+
+    private:
+        const Trajectory trajectory;
+        const double step_time, tolerance;
+        playback_clock playback {};
+        fixed_step_clock stepper;
+        trail_polyline polyline {};
+        std::vector<TrailPoint> points {};
+        std::size_t step_count {};
+
+        void add_point(double time, bool replaces_tip){
+            const TrailPoint point {time, trajectory.x_at(time), trajectory.y_at(time)};
+            if (replaces_tip)
+                points.back() = point;
+            else
+                points.push_back(point);
+        }
+
+    public:
+        // step_seconds of real time move the playback by step_time, the trail is sampled to within tolerance
+        fixed_step_run(const Trajectory &trajectory, double step_seconds, double step_time, double tolerance):
+            trajectory(trajectory), step_time(step_time), tolerance(tolerance), stepper(step_seconds) {
+            playback.reset(trajectory.end_time);
+            add_point(0, false);
+        }
+
+        // One simulation step
+        void step(){
+            playback.step(1, step_time);
+            polyline.extend(trajectory, playback.get_time(), tolerance, [&](double time, bool replaces_tip){ add_point(time, replaces_tip); });
+            step_count++;
+        }
+
+        // Runs the steps that are due after real_seconds of wall time at the given playback speed
+        void frame(double real_seconds, double speed = 1){
+            const int steps = stepper.accumulate(real_seconds * speed);
+            for (int i = 0; i < steps && !finished(); i++)
+                step();
+        }
+
+        // Runs every remaining step without waiting for real time
+        void fast_forward(){
+            while (!finished())
+                step();
+            stepper.reset();
+        }
+
+        bool finished() const { return playback.at_end(); }
+        double time() const { return playback.get_time(); }
+        std::size_t steps() const { return step_count; }
+        const std::vector<TrailPoint> &trail() const { return points; }
+};
+
+// Samples of a trajectory from launch to landing, x from the launch point and y from the ground, either at evenly
+// spaced times or at the times of sample_polyline(); the last sample is at the landing time itself
+// Samples are generated chunk by chunk the first time a row of the chunk is read, and only a few chunks are
+// kept, so even millions of samples cost nothing until they are looked at
+class trajectory_samples{
+    public:
+        struct Sample{
+            double time, x, y;
+        };
+
+    private:
+        static constexpr std::size_t CHUNK_SAMPLES {1024}, CACHED_CHUNKS {16};
+        static constexpr std::size_t NO_CHUNK {static_cast<std::size_t>(-1)};
+
+        struct chunk{
+            std::size_t index {NO_CHUNK};
+            std::vector<Sample> samples {};
+        };
+
+        Trajectory trajectory {};
+        std::size_t count {};
+        double time_step {};
+        std::vector<double> times {}; // Times of the samples, empty when they are evenly spaced
+        std::vector<chunk> cache = std::vector<chunk>(CACHED_CHUNKS); // Chunk k lives in slot k % CACHED_CHUNKS
+        std::size_t generated_chunks {};
+
+        const chunk &load_chunk(std::size_t index){
+            chunk &slot = cache[index % CACHED_CHUNKS];
+            if (slot.index == index)
+                return slot;
+
+            const std::size_t first = index * CHUNK_SAMPLES;
+            const std::size_t length = count - first < CHUNK_SAMPLES ? count - first : CHUNK_SAMPLES;
+            slot.samples.resize(length);
+            for (std::size_t i = 0; i < length; i++){
+                const double time = !times.empty() ? times[first + i] : (first + i == count - 1 ? trajectory.end_time : (first + i) * time_step);
+                slot.samples[i] = {time, trajectory.x_at(time), trajectory.y_at(time)};
+            }
+            slot.index = index;
+            generated_chunks++;
+            return slot;
+        }
+
+    public:
+        // Drops every generated sample, nothing is computed until the first read
+        void reset(const Trajectory &new_trajectory, std::size_t sample_count){
+            trajectory = new_trajectory;
+            count = new_trajectory.end_time > 0 ? sample_count : 0;
+            time_step = count > 1 ? new_trajectory.end_time / (count - 1) : 0;
+            times.clear();
+            for (chunk &slot : cache)
+                slot.index = NO_CHUNK;
+        }
+
+        // Samples at the times of sample_polyline() for tolerance; only the times are computed now
+        void reset_adaptive(const Trajectory &new_trajectory, double tolerance){
+            trajectory = new_trajectory;
+            times.clear();
+            if (new_trajectory.end_time > 0)
+                sample_polyline(new_trajectory, 0, new_trajectory.end_time, tolerance, times);
+            count = times.size();
+            time_step = 0;
+            for (chunk &slot : cache)
+                slot.index = NO_CHUNK;
+        }
+
+        // Times of the adaptive samples, empty when they are evenly spaced
+        const std::vector<double> &adaptive_times() const { return times; }
+
+        std::size_t size() const { return count; }
+
+        // Chunks computed since the program started, for diagnostics
+        std::size_t chunks_generated() const { return generated_chunks; }
+
+        // i must be below size()
+        const Sample &operator[](std::size_t i){
+            return load_chunk(i / CHUNK_SAMPLES).samples[i % CHUNK_SAMPLES];
+        }
+};
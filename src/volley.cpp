@@ -0,0 +1,90 @@
+#include "volley.hpp"
+#include "counter_rng.hpp"
+#include <cmath>
+
+void volley::append(std::size_t count){
+    const std::size_t total = x.size() + count;
+    for (std::vector<double> *column : {&x, &y, &vx, &vy, &ax, &ay})
+        column->resize(total);
+}
+
+void volley::add_fan(const VolleyLaunch &launch, double angle_from, double angle_to, std::size_t count){
+    const std::size_t first = x.size();
+    append(count);
+    for (std::size_t i = 0; i < count; i++){
+        const double angle = count > 1 ? angle_from + (angle_to - angle_from) * i / (count - 1) : angle_from;
+        const double radians = angle * (M_PI / 180.0);
+        const std::size_t p = first + i;
+        x[p] = 0;
+        y[p] = launch.y_initial;
+        vx[p] = launch.speed * std::cos(radians);
+        vy[p] = launch.speed * std::sin(radians);
+        ax[p] = 0;
+        ay[p] = launch.acc;
+    }
+}
+
+void volley::add_cloud(const VolleyLaunch &launch, double speed_sigma, double angle_sigma, std::size_t count, std::uint64_t seed){
+    const std::size_t first = x.size();
+    append(count);
+    for (std::size_t i = 0; i < count; i++){
+        const std::size_t p = first + i;
+        const double speed = launch.speed + speed_sigma * counter_rng{seed, p, 0}.normal();
+        const double radians = (launch.angle + angle_sigma * counter_rng{seed, p, 1}.normal()) * (M_PI / 180.0);
+        x[p] = 0;
+        y[p] = launch.y_initial;
+        vx[p] = speed * std::cos(radians);
+        vy[p] = speed * std::sin(radians);
+        ax[p] = 0;
+        ay[p] = launch.acc;
+    }
+}
+
+void volley::clear(){
+    for (std::vector<double> *column : {&x, &y, &vx, &vy, &ax, &ay})
+        column->clear();
+    landed_count = 0;
+}
+
+void volley::advance(double dt, thread_pool &pool, const obstacle_grid *obstacles, double origin_x, double origin_y){
+    if (dt <= 0 || x.empty())
+        return;
+    const bool collide = obstacles != nullptr && obstacles->size() > 0;
+
+    chunk_landed.assign((x.size() + CHUNK - 1) / CHUNK, 0);
+    pool.parallel_for(x.size(), CHUNK, [&](std::size_t begin, std::size_t end){
+        double *px = x.data(), *py = y.data(), *pvx = vx.data(), *pvy = vy.data(), *pax = ax.data(), *pay = ay.data();
+        std::size_t landings {};
+        for (std::size_t i = begin; i < end; i++){
+            const double next_y = py[i] + dt * (pvy[i] + 0.5 * dt * pay[i]);
+            // Later root of y + vy t + ay t^2 / 2 = 0 when the ground comes within the step
+            const bool grounded = next_y < 0;
+            double impact = grounded ? (pay[i] < 0 ? (-pvy[i] - std::sqrt(pvy[i] * pvy[i] - 2 * pay[i] * py[i])) / pay[i] : -py[i] / pvy[i]) : dt;
+            bool blocked {false};
+            if (collide && (pvx[i] != 0 || pvy[i] != 0 || pax[i] != 0 || pay[i] != 0)){
+                const ObstacleHit hit = obstacles->first_hit({origin_x + px[i], origin_y + py[i], pvx[i], pvy[i], pax[i], pay[i]}, impact);
+                if (hit.hit){
+                    impact = hit.time;
+                    blocked = true;
+                }
+            }
+
+            if (grounded || blocked){ // Rests where it hit
+                px[i] += impact * (pvx[i] + 0.5 * impact * pax[i]);
+                py[i] = blocked ? py[i] + impact * (pvy[i] + 0.5 * impact * pay[i]) : 0;
+                pvx[i] = pvy[i] = 0;
+                pax[i] = pay[i] = 0;
+                landings++;
+                continue;
+            }
+            px[i] += dt * (pvx[i] + 0.5 * dt * pax[i]);
+            py[i] = next_y;
+            pvx[i] += dt * pax[i];
+            pvy[i] += dt * pay[i];
+        }
+        chunk_landed[begin / CHUNK] = landings;
+    });
+
+    for (std::size_t landings : chunk_landed)
+        landed_count += landings;
+}
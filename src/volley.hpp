@@ -0,0 +1,52 @@
+#pragma once
+
+// Many projectiles in flight at once: volleys such as the whole angle fan of one speed or a cloud of uncertain launches
+// Positions, velocities and accelerations live in structure-of-arrays columns and are advanced in parallel chunks.
+// The acceleration stays constant during a flight, so a step is exact for any step size, and a projectile that
+// reaches the ground or an obstacle during a step is placed on the point of impact in closed form and stays there
+#include "collision.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Launch shared by every projectile of a fan or a cloud
+struct VolleyLaunch{
+    double speed {80};
+    double angle {45}; // Degrees
+    double acc {-9.81};
+    double y_initial {};
+};
+
+class volley{
+    private:
+        std::vector<double> x {}, y {}, vx {}, vy {}, ax {}, ay {};
+        std::vector<std::size_t> chunk_landed {}; // Impacts of the last step, one entry per chunk
+        std::size_t landed_count {};
+
+        void append(std::size_t count);
+
+    public:
+        static constexpr std::size_t CHUNK {8192}; // Projectiles per parallel task
+
+        // count projectiles at the speed of launch, with angles evenly spread over [angle_from, angle_to]
+        void add_fan(const VolleyLaunch &launch, double angle_from, double angle_to, std::size_t count);
+
+        // count projectiles with speed and angle drawn from normal distributions around launch
+        // The draws are keyed by seed and the index of the projectile, so a cloud looks the same every time
+        void add_cloud(const VolleyLaunch &launch, double speed_sigma, double angle_sigma, std::size_t count, std::uint64_t seed);
+
+        void clear();
+
+        // Moves every projectile by dt seconds, stopping the ones that hit the ground or one of the obstacles
+        // (origin_x, origin_y) is the launch point in the coordinates of the obstacles
+        void advance(double dt, thread_pool &pool, const obstacle_grid *obstacles = nullptr, double origin_x = 0, double origin_y = 0);
+
+        std::size_t size() const { return x.size(); }
+        std::size_t landed() const { return landed_count; } // On the ground or on an obstacle
+        bool all_landed() const { return landed_count == x.size(); }
+
+        // Positions relative to the launch point on the ground, size() entries each
+        const double *x_positions() const { return x.data(); }
+        const double *y_positions() const { return y.data(); }
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+// Draws every projectile of a volley with one call
+// SFML has no instanced drawing, so the instancing happens on the CPU: the same marker quad (two triangles) is placed
+// at every projectile, chunk by chunk on the thread pool, into one stream vertex buffer that is drawn at once.
+// Colors are written when markers are added, every frame only moves the corners
+#include "thread_pool.hpp"
+#include "volley.hpp"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+class volley_batch{
+    private:
+        static constexpr std::size_t MARKER_VERTICES {6};
+        const float half_size;
+
+        std::vector<sf::Vertex> vertices {};
+        sf::VertexBuffer buffer {sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Stream};
+        bool use_buffer {sf::VertexBuffer::isAvailable()}; // Falls back to drawing straight from memory without GPU buffers
+
+    public:
+        explicit volley_batch(float marker_size = 3.f): half_size(marker_size / 2) {}
+
+        // Adds count markers, colored from `from` for the first one to `to` for the last one
+        void add(std::size_t count, sf::Color from, sf::Color to){
+            const std::size_t first = vertices.size();
+            vertices.resize(first + count * MARKER_VERTICES);
+            for (std::size_t i = 0; i < count; i++){
+                const float t = count > 1 ? static_cast<float>(i) / (count - 1) : 0.f;
+                auto mix = [t](std::uint8_t a, std::uint8_t b){ return static_cast<std::uint8_t>(a + (b - a) * t); };
+                const sf::Color color {mix(from.r, to.r), mix(from.g, to.g), mix(from.b, to.b), mix(from.a, to.a)};
+                for (std::size_t v = 0; v < MARKER_VERTICES; v++)
+                    vertices[first + i * MARKER_VERTICES + v].color = color;
+            }
+        }
+
+        void clear() { vertices.clear(); }
+
+        // Places the markers at the projectiles, (origin_x, origin_y) is the launch point on screen
+        void update(const volley &projectiles, thread_pool &pool, float origin_x, float origin_y){
+            const double *x = projectiles.x_positions(), *y = projectiles.y_positions();
+            const sf::Vector2f corner[MARKER_VERTICES] {{-half_size, -half_size}, {half_size, -half_size}, {half_size, half_size},
+                                                        {-half_size, -half_size}, {half_size, half_size}, {-half_size, half_size}};
+            pool.parallel_for(projectiles.size(), volley::CHUNK, [&](std::size_t begin, std::size_t end){
+                for (std::size_t i = begin; i < end; i++){
+                    const sf::Vector2f center {origin_x + static_cast<float>(x[i]), origin_y - static_cast<float>(y[i])};
+                    sf::Vertex *marker = vertices.data() + i * MARKER_VERTICES;
+                    for (std::size_t v = 0; v < MARKER_VERTICES; v++)
+                        marker[v].position = center + corner[v];
+                }
+            });
+
+            if (!use_buffer || vertices.empty())
+                return;
+            if (buffer.getVertexCount() != vertices.size() && !buffer.create(vertices.size())){
+                use_buffer = false;
+                return;
+            }
+            buffer.update(vertices.data());
+        }
+
+        // Returns the number of draw calls issued
+        unsigned int draw(sf::RenderTarget &target) const {
+            if (vertices.empty())
+                return 0;
+            if (use_buffer)
+                target.draw(buffer, 0, vertices.size());
+            else
+                target.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+            return 1;
+        }
+};
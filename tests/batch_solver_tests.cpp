@@ -0,0 +1,93 @@
+#include "batch_solver.hpp"
+#include "kinematics_core.hpp"
+#include "test_harness.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// Distance in units in the last place, for values of the same sign
+double ulp_distance(double a, double b){
+    if (a == b)
+        return 0;
+    if (std::isnan(a) || std::isnan(b) || std::signbit(a) != std::signbit(b))
+        return std::numeric_limits<double>::infinity();
+    std::int64_t bits_a {}, bits_b {};
+    std::memcpy(&bits_a, &a, sizeof(a));
+    std::memcpy(&bits_b, &b, sizeof(b));
+    return static_cast<double>(bits_a > bits_b ? bits_a - bits_b : bits_b - bits_a);
+}
+
+// Angle inputs of every kernel stay within BATCH_ULP_TOLERANCE ULP of find_unknown(), see batch_solver.hpp
+// Outputs that cancel to (almost) zero are compared against the size of the lane instead
+void test_batch_matches_scalar(){
+    const Parameter KNOWN_CHOICES[] {Parameter::INITIAL_SPEED, Parameter::ACC, Parameter::TIME, Parameter::RANGE, Parameter::MAX_HEIGHT};
+    const Parameter COMPARED[] {Parameter::INITIAL_SPEED, Parameter::FINAL_SPEED, Parameter::ACC, Parameter::TIME, Parameter::RANGE,
+                                Parameter::MAX_HEIGHT, Parameter::ABS_MAX_HEIGHT, Parameter::TIME_OF_APEX};
+    const std::size_t SCENARIOS {20000};
+    test_random random {42};
+
+    std::vector<ParameterValues> tables {};
+    while (tables.size() < SCENARIOS){
+        // A consistent ground launch, the angle and three of its other values are given
+        const double speed = random.uniform(5, 300), angle = random.uniform(1, 89), acc = random.uniform(-50, -1);
+        const double theta = angle * (M_PI / 180), time = -2 * speed * std::sin(theta) / acc;
+        const double launch[] {speed, acc, time, speed * std::cos(theta) * time, -speed * speed * std::sin(theta) * std::sin(theta) / (2 * acc)};
+
+        ParameterValues table {};
+        table[Parameter::ANGLE] = angle;
+        unsigned chosen {};
+        while (__builtin_popcount(chosen) < 3)
+            chosen |= 1u << static_cast<unsigned>(random.uniform(0, 5));
+        for (std::size_t k = 0; k < 5; k++){
+            if (chosen & (1u << k))
+                table[KNOWN_CHOICES[k]] = launch[k];
+        }
+        table[Parameter::FINAL_SPEED] = table[Parameter::INITIAL_SPEED];
+
+        ParameterValues solved = table;
+        if (cleanup_input(solved).ok())
+            tables.push_back(table);
+    }
+
+    std::vector<BatchKernel> kernels {BatchKernel::SCALAR};
+    if (best_batch_kernel() != BatchKernel::SCALAR)
+        kernels.push_back(BatchKernel::SSE2);
+    if (best_batch_kernel() == BatchKernel::AVX2)
+        kernels.push_back(BatchKernel::AVX2);
+
+    for (BatchKernel kernel : kernels){
+        ScenarioBatch batch {};
+        batch.resize(tables.size());
+        for (std::size_t lane = 0; lane < tables.size(); lane++)
+            batch.store(lane, tables[lane]);
+        find_unknown_batch(batch, kernel);
+        const ScenarioColumns columns = batch.columns();
+
+        double worst {};
+        for (std::size_t lane = 0; lane < tables.size(); lane++){
+            ParameterValues expected = tables[lane], actual = tables[lane];
+            cleanup_input(expected);
+            columns.load(lane, actual);
+            if (!CHECK(batch.status[lane] == SolveStatus::SOLVED))
+                continue;
+
+            // Heights over a full flight cancel vy t against acc t^2 / 2, which are as large as acc t^2
+            double scale = std::fabs(expected[Parameter::ACC]) * expected[Parameter::TIME] * expected[Parameter::TIME];
+            for (Parameter parameter : COMPARED)
+                scale = std::max(scale, std::fabs(expected[parameter]));
+            for (Parameter parameter : COMPARED){
+                const double ulps = ulp_distance(actual[parameter], expected[parameter]);
+                if (ulps <= BATCH_ULP_TOLERANCE)
+                    worst = std::max(worst, ulps);
+                else if (!CHECK(std::fabs(actual[parameter] - expected[parameter]) <= BATCH_ULP_TOLERANCE * std::numeric_limits<double>::epsilon() * scale))
+                    std::cerr << "  lane " << lane << ", " << parameter_info(parameter).name << ": " << actual[parameter] << " instead of " << expected[parameter] << "\n";
+            }
+        }
+        std::cout << batch_kernel_name(kernel) << ": " << tables.size() << " scenarios, at most " << worst << " ULP where the values do not cancel\n";
+    }
+}
+
+const register_test BATCH_MATCHES_SCALAR {"batch_matches_scalar", test_batch_matches_scalar};
@@ -0,0 +1,45 @@
+#include "columnar_export.hpp"
+#include "kinematics_core.hpp"
+#include "test_harness.hpp"
+#include "trajectory.hpp"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// The last exported row is the landing, so it holds the solved TIME and RANGE like the header says
+void test_export_last_row(){
+    for (double y_initial : {0.0, 10.0}){
+        const double speed {40}, acc {-9.81}, vy = speed * std::sin(M_PI / 6);
+        ParameterValues parameters {};
+        parameters[Parameter::INITIAL_SPEED] = speed;
+        parameters[Parameter::ACC] = acc;
+        parameters[Parameter::ANGLE] = 30;
+        parameters[Parameter::Y_INITIAL] = y_initial;
+        if (y_initial == 0)
+            parameters[Parameter::FINAL_SPEED] = speed;
+        else
+            parameters[Parameter::TIME] = (-vy - std::sqrt(vy * vy - 2 * acc * y_initial)) / acc;
+        if (!CHECK(cleanup_input(parameters).ok()))
+            continue;
+
+        const std::string path {"kinematics_core_tests_export.csv"};
+        std::string error {};
+        if (!CHECK(export_trajectory(path, ExportFormat::CSV, make_trajectory(parameters), parameters, 100, error)))
+            continue;
+        std::ifstream file {path};
+        std::string line {}, last {};
+        while (std::getline(file, line))
+            last = line;
+        file.close();
+        std::remove(path.c_str());
+
+        double time {}, x {}, y {};
+        CHECK(std::sscanf(last.c_str(), "%lf,%lf,%lf", &time, &x, &y) == 3);
+        CHECK(close_to(time, parameters[Parameter::TIME], 1e-12));
+        CHECK(close_to(x, parameters[Parameter::RANGE], 1e-12));
+        CHECK(std::fabs(y) <= 1e-9);
+    }
+}
+
+const register_test EXPORT_LAST_ROW {"export_last_row", test_export_last_row};
@@ -0,0 +1,24 @@
+#include "counter_rng.hpp"
+#include "test_harness.hpp"
+#include <cstdint>
+
+// Philox4x32-10 known-answer vectors of Random123 (kat_vectors)
+void test_philox_known_answers(){
+    struct known_answer{
+        philox_block counter;
+        std::uint64_t key;
+        philox_block expected;
+    };
+    const known_answer VECTORS[] {
+        {{{0, 0, 0, 0}}, 0, {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}},
+        {{{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}}, 0xffffffffffffffff, {{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}},
+        {{{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}, 0x299f31d0a4093822, {{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}},
+    };
+    for (const known_answer &vector : VECTORS){
+        const philox_block block = philox4x32(vector.counter, vector.key);
+        for (int w = 0; w < 4; w++)
+            CHECK(block.word[w] == vector.expected.word[w]);
+    }
+}
+
+const register_test PHILOX_KNOWN_ANSWERS {"philox_known_answers", test_philox_known_answers};
@@ -0,0 +1,63 @@
+#include "forces.hpp"
+#include "test_harness.hpp"
+#include <cmath>
+#include <vector>
+
+// The RK45 integrator against motions with closed forms
+void test_forces_closed_forms(){
+    const double G {-9.81};
+    std::vector<ForceBody> bodies(3);
+
+    // Projectile without drag, lands at the later root of y0 + vy t + g t^2 / 2
+    ForceBody &flight = bodies[0];
+    flight.y = 5;
+    flight.vx = 20;
+    flight.vy = 15;
+    flight.acc = G;
+    flight.end_time = 100;
+
+    // Block slowed by friction alone, stops after v0 / (mu g) having slid v0^2 / (2 mu g) and rests until end_time
+    ForceBody &block = bodies[1];
+    block.kind = BodyKind::BLOCK;
+    block.friction = 0.3;
+    block.vx = 12;
+    block.acc = G;
+    block.end_time = 100;
+
+    // Projectile with linear drag only, stopped in the air: v(t) = v_terminal + (v0 - v_terminal) e^(-b t / m)
+    ForceBody &drag = bodies[2];
+    drag.mass = 2;
+    drag.linear_drag = 0.4;
+    drag.y = 100;
+    drag.vx = 30;
+    drag.vy = 10;
+    drag.acc = G;
+    drag.end_time = 3;
+
+    const std::vector<ForceRun> runs = integrate_bodies(bodies);
+
+    const double landing = (-flight.vy - std::sqrt(flight.vy * flight.vy - 2 * G * flight.y)) / G;
+    CHECK(runs[0].end == ForceEnd::LANDED);
+    CHECK(close_to(runs[0].trajectory.end_time(), landing, 1e-12));
+    CHECK(close_to(runs[0].trajectory.state_at(landing).x, flight.vx * landing, 1e-12));
+    CHECK(close_to(runs[0].trajectory.state_at(landing / 2).y, flight.y + flight.vy * landing / 2 + G * landing * landing / 8, 1e-12));
+
+    const double deceleration = -block.friction * G;
+    const double stop = block.vx / deceleration;
+    CHECK(runs[1].end == ForceEnd::STOPPED);
+    CHECK(close_to(runs[1].trajectory.state_at(stop / 2).vx, block.vx / 2, 1e-12));
+    CHECK(close_to(runs[1].trajectory.state_at(stop).x, block.vx * block.vx / (2 * deceleration), 1e-12));
+    CHECK(close_to(runs[1].trajectory.state_at(block.end_time).x, block.vx * block.vx / (2 * deceleration), 1e-12));
+    CHECK(runs[1].trajectory.state_at(block.end_time).vx == 0);
+
+    const double rate = drag.linear_drag / drag.mass, t = drag.end_time, decay = std::exp(-rate * t);
+    const double terminal = G / rate;
+    const ForceState end = runs[2].trajectory.state_at(t);
+    CHECK(runs[2].end == ForceEnd::TIME_LIMIT);
+    CHECK(close_to(end.vx, drag.vx * decay, 1e-9));
+    CHECK(close_to(end.x, drag.vx * (1 - decay) / rate, 1e-9));
+    CHECK(close_to(end.vy, terminal + (drag.vy - terminal) * decay, 1e-9));
+    CHECK(close_to(end.y, drag.y + terminal * t + (drag.vy - terminal) * (1 - decay) / rate, 1e-9));
+}
+
+const register_test FORCES_CLOSED_FORMS {"forces_closed_forms", test_forces_closed_forms};
@@ -0,0 +1,64 @@
+#include "height_solver.hpp"
+#include "test_harness.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+// Every three knowns that fix a launch from a height converge to a launch that matches them
+// Some sets are met by a low and a high arc, so the solved launch is checked against its own speed, angle and
+// acceleration rather than against the launch the knowns came from
+void test_height_known_sets(){
+    const double Y_INITIAL {12};
+    const unsigned BITS[] {KNOWN_V_INITIAL, KNOWN_ANGLE, KNOWN_ACC, KNOWN_TIME, KNOWN_RANGE, KNOWN_MAX_HEIGHT, KNOWN_V_FINAL};
+    double HeightLaunch::*const MEMBERS[] {&HeightLaunch::v_initial, &HeightLaunch::angle, &HeightLaunch::acc, &HeightLaunch::time,
+                                           &HeightLaunch::range, &HeightLaunch::max_height, &HeightLaunch::v_final};
+
+    HeightLaunch truth {};
+    truth.v_initial = 30;
+    truth.angle = 35;
+    truth.acc = -9.81;
+    const double theta = truth.angle * (M_PI / 180), vx = truth.v_initial * std::cos(theta), vy = truth.v_initial * std::sin(theta);
+    truth.time = (-vy - std::sqrt(vy * vy - 2 * truth.acc * Y_INITIAL)) / truth.acc;
+    truth.range = vx * truth.time;
+    truth.max_height = -vy * vy / (2 * truth.acc);
+    truth.v_final = std::sqrt(truth.v_initial * truth.v_initial - 2 * truth.acc * Y_INITIAL);
+
+    int supported {}, converged {};
+    for (unsigned known = 0; known < 128; known++){
+        if (__builtin_popcount(known) != 3)
+            continue;
+        if (!height_known_set_supported(known)){
+            CHECK(std::find(std::begin(HEIGHT_UNDERDETERMINED_SETS), std::end(HEIGHT_UNDERDETERMINED_SETS), known) != std::end(HEIGHT_UNDERDETERMINED_SETS));
+            continue;
+        }
+        supported++;
+
+        HeightLaunch launch {};
+        for (std::size_t b = 0; b < 7; b++){
+            if (known & BITS[b])
+                launch.*MEMBERS[b] = truth.*MEMBERS[b];
+        }
+        const HeightSolveReport report = solve_launch_from_height(Y_INITIAL, known, launch);
+        if (!CHECK(report.converged)){
+            std::cerr << "  known set " << known << " did not converge\n";
+            continue;
+        }
+        converged++;
+        const double solved_theta = launch.angle * (M_PI / 180);
+        const double solved_vx = launch.v_initial * std::cos(solved_theta), solved_vy = launch.v_initial * std::sin(solved_theta);
+        const double solved_time = (-solved_vy - std::sqrt(solved_vy * solved_vy - 2 * launch.acc * Y_INITIAL)) / launch.acc;
+        HeightLaunch expected {launch.v_initial, launch.angle, launch.acc, solved_time, solved_vx * solved_time, -solved_vy * solved_vy / (2 * launch.acc),
+                               std::sqrt(launch.v_initial * launch.v_initial - 2 * launch.acc * Y_INITIAL)};
+        for (std::size_t b = 0; b < 7; b++){
+            if (known & BITS[b])
+                expected.*MEMBERS[b] = truth.*MEMBERS[b];
+            if (!CHECK(close_to(launch.*MEMBERS[b], expected.*MEMBERS[b], 1e-9)))
+                std::cerr << "  known set " << known << ", quantity " << b << ": " << launch.*MEMBERS[b] << " instead of " << expected.*MEMBERS[b] << "\n";
+        }
+    }
+    CHECK(supported == 32);
+    CHECK(converged == 32);
+}
+
+const register_test HEIGHT_KNOWN_SETS {"height_known_sets", test_height_known_sets};
@@ -0,0 +1,30 @@
+// Checks of the headless core against the bounds and closed forms the solvers promise
+// The tests live next to the module they check (tests/<module>_tests.cpp) and register themselves by name
+#include "test_harness.hpp"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+int failures {};
+
+std::vector<named_test> &registered_tests(){
+    static std::vector<named_test> tests {};
+    return tests;
+}
+
+int main(int argc, char **argv){
+    bool found {argc < 2};
+    for (const named_test &test : registered_tests()){
+        if (argc >= 2 && std::strcmp(argv[1], test.name) != 0)
+            continue;
+        found = true;
+        const int before = failures;
+        test.run();
+        std::cout << test.name << (failures == before ? ": passed\n" : ": FAILED\n");
+    }
+    if (!found){
+        std::cerr << "No test named " << argv[1] << "\n";
+        return 2;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#include "kinematics_core.hpp"
+#include "solver_protocol.hpp"
+#include "test_harness.hpp"
+#include <cstring>
+#include <vector>
+
+// Requests and responses decode to what was encoded, split frames wait for the rest
+void test_protocol_round_trip(){
+    ParameterValues parameters {};
+    parameters[Parameter::INITIAL_SPEED] = 20;
+    parameters[Parameter::FINAL_SPEED] = 20;
+    parameters[Parameter::ACC] = -9.81;
+    parameters[Parameter::ANGLE] = 0; // Differs from the default of 45, so it is sent as well
+    parameters[Parameter::Y_INITIAL] = 3.5;
+
+    std::vector<char> stream {};
+    append_request(stream, 17, parameters);
+    const std::size_t first_frame = stream.size();
+    append_request(stream, 18, ParameterValues{});
+
+    SolverRequest request {};
+    std::size_t consumed {};
+    CHECK(read_request(stream.data(), first_frame - 1, request, consumed) == FrameStatus::INCOMPLETE);
+    CHECK(read_request(stream.data(), stream.size(), request, consumed) == FrameStatus::COMPLETE);
+    CHECK(consumed == first_frame);
+    CHECK(request.id == 17);
+    CHECK(std::memcmp(request.parameters.value, parameters.value, sizeof(parameters.value)) == 0);
+    CHECK(read_request(stream.data() + consumed, stream.size() - consumed, request, consumed) == FrameStatus::COMPLETE);
+    CHECK(request.id == 18);
+    CHECK(request.parameters[Parameter::ANGLE] == parameter_info(Parameter::ANGLE).default_value);
+
+    // A request naming a parameter that does not exist can not be trusted
+    std::vector<char> broken {};
+    append_request(broken, 1, parameters);
+    broken[FRAME_HEADER_BYTES + 5] = static_cast<char>(PARAMETER_COUNT);
+    CHECK(read_request(broken.data(), broken.size(), request, consumed) == FrameStatus::MALFORMED);
+
+    SolverResponse response {};
+    response.id = 99;
+    response.parameters = parameters;
+    response.check = cleanup_input(response.parameters);
+    std::vector<char> reply {};
+    append_response(reply, response);
+    CHECK(reply.size() == FRAME_HEADER_BYTES + RESPONSE_BODY);
+
+    SolverResponse decoded {};
+    CHECK(read_response(reply.data(), reply.size(), decoded, consumed) == FrameStatus::COMPLETE);
+    CHECK(consumed == reply.size());
+    CHECK(decoded.id == response.id);
+    CHECK(decoded.check.error == response.check.error);
+    CHECK(std::memcmp(decoded.parameters.value, response.parameters.value, sizeof(response.parameters.value)) == 0);
+}
+
+const register_test PROTOCOL_ROUND_TRIP {"protocol_round_trip", test_protocol_round_trip};
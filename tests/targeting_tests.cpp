@@ -0,0 +1,49 @@
+#include "targeting.hpp"
+#include "test_harness.hpp"
+#include <cmath>
+#include <cstddef>
+
+// Every solved arc passes through its target
+void test_targeting_residuals(){
+    const std::size_t TARGETS {4096};
+    test_random random {7};
+
+    for (TargetConstraint constraint : {TargetConstraint::FIXED_SPEED, TargetConstraint::FIXED_ANGLE}){
+        for (double y_initial : {0.0, 25.0}){
+            TargetingProblem problem {};
+            problem.constraint = constraint;
+            problem.speed = 60;
+            problem.angle = 50;
+            problem.y_initial = y_initial;
+
+            TargetBatch targets {};
+            targets.resize(TARGETS);
+            for (std::size_t i = 0; i < TARGETS; i++){
+                targets.x[i] = random.uniform(1, 400);
+                targets.y[i] = random.uniform(0, 150);
+            }
+            solve_targets(problem, targets);
+
+            std::size_t hits {};
+            for (std::size_t i = 0; i < TARGETS; i++){
+                for (std::size_t arc = LOW_ARC; arc < ARC_COUNT; arc++){
+                    const double angle = targets.angle[arc][i], speed = targets.speed[arc][i], time = targets.time[arc][i];
+                    if (std::isnan(angle))
+                        continue;
+                    const double theta = angle * (M_PI / 180);
+                    const double x = speed * std::cos(theta) * time, y = y_initial + speed * std::sin(theta) * time + problem.acc * time * time / 2;
+                    CHECK(close_to(x, targets.x[i], 1e-9));
+                    CHECK(close_to(y, targets.y[i], 1e-9));
+                    if (constraint == TargetConstraint::FIXED_SPEED)
+                        CHECK(close_to(speed, problem.speed, 1e-12));
+                    else
+                        CHECK(close_to(angle, problem.angle, 1e-12));
+                    hits++;
+                }
+            }
+            CHECK(hits > 0);
+        }
+    }
+}
+
+const register_test TARGETING_RESIDUALS {"targeting_residuals", test_targeting_residuals};
@@ -0,0 +1,50 @@
+#pragma once
+
+// Minimal harness of kinematics_core_tests: every test file registers its tests by name, the executable runs one
+// of them (`kinematics_core_tests name`, as ctest does) or all of them
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Failed checks so far, over every test that ran
+extern int failures;
+
+// Reports a failed check without stopping the test, so one run shows every failure
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+inline bool check(bool passed, const char *expression, const char *file, int line){
+    if (!passed){
+        std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+        failures++;
+    }
+    return passed;
+}
+
+inline bool close_to(double value, double expected, double relative){
+    return std::fabs(value - expected) <= relative * std::max(1.0, std::fabs(expected));
+}
+
+// Small linear congruential generator, the tests only need repeatable values
+struct test_random{
+    std::uint64_t state;
+
+    double uniform(double low, double high){
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return low + (high - low) * (static_cast<double>(state >> 11) * 0x1.0p-53);
+    }
+};
+
+struct named_test{
+    const char *name;
+    void (*run)();
+};
+
+// Every registered test, in no particular order
+std::vector<named_test> &registered_tests();
+
+// Registers a test from a static object: `const register_test NAME {"name", function};`
+struct register_test{
+    register_test(const char *name, void (*run)()) { registered_tests().push_back({name, run}); }
+};
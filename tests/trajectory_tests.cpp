@@ -0,0 +1,73 @@
+#include "kinematics_core.hpp"
+#include "test_harness.hpp"
+#include "trajectory.hpp"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Playback ends where the table says the launch lands, x from the launch point and y from the ground
+// A 30 degree launch: both speeds and the acceleration from the ground, speed, acceleration and flight time from a
+// height, where the angle is solved for
+void test_trajectory_end(){
+    for (double y_initial : {0.0, 10.0}){
+        const double speed {40}, acc {-9.81}, vy = speed * std::sin(M_PI / 6);
+        ParameterValues parameters {};
+        parameters[Parameter::INITIAL_SPEED] = speed;
+        parameters[Parameter::ACC] = acc;
+        parameters[Parameter::ANGLE] = 30;
+        parameters[Parameter::Y_INITIAL] = y_initial;
+        if (y_initial == 0)
+            parameters[Parameter::FINAL_SPEED] = speed;
+        else
+            parameters[Parameter::TIME] = (-vy - std::sqrt(vy * vy - 2 * acc * y_initial)) / acc;
+        if (!CHECK(cleanup_input(parameters).ok()))
+            continue;
+
+        const Trajectory trajectory = make_trajectory(parameters);
+        CHECK(close_to(trajectory.end_time, parameters[Parameter::TIME], 1e-12));
+        CHECK(close_to(trajectory.x_at(trajectory.end_time), parameters[Parameter::RANGE], 1e-12));
+        CHECK(std::fabs(trajectory.y_at(trajectory.end_time)) <= 1e-9);
+        CHECK(trajectory.x_at(0) == 0);
+        CHECK(trajectory.y_at(0) == y_initial);
+    }
+}
+
+// Playing a launch frame by frame at any frame rate or playback speed, or fast-forwarding it without frames, takes
+// the same steps and leaves the same trail, bit for bit
+void test_fixed_step_frame_rates(){
+    const double STEP_SECONDS {1.0 / 60}, STEP_TIME {0.1}, TOLERANCE {0.5}; // As in the simulator
+    ParameterValues parameters {};
+    parameters[Parameter::INITIAL_SPEED] = 60;
+    parameters[Parameter::FINAL_SPEED] = 60;
+    parameters[Parameter::ACC] = -9.81;
+    parameters[Parameter::ANGLE] = 55;
+    if (!CHECK(cleanup_input(parameters).ok()))
+        return;
+    const Trajectory trajectory = make_trajectory(parameters);
+
+    fixed_step_run reference {trajectory, STEP_SECONDS, STEP_TIME, TOLERANCE};
+    reference.fast_forward();
+    CHECK(reference.finished());
+    CHECK(reference.trail().size() > 2);
+
+    struct frame_pattern{
+        double fps, speed;
+        bool jitter; // Frames between 3 ms and 120 ms, longer than the backlog the clock keeps
+    };
+    const frame_pattern PATTERNS[] {{30, 1, false}, {60, 1, false}, {144, 1, false}, {240, 1, false}, {60, 3, false}, {60, 1, true}};
+    for (const frame_pattern &pattern : PATTERNS){
+        fixed_step_run run {trajectory, STEP_SECONDS, STEP_TIME, TOLERANCE};
+        test_random random {11};
+        for (int frame = 0; frame < 1000000 && !run.finished(); frame++)
+            run.frame(pattern.jitter ? random.uniform(0.003, 0.12) : 1 / pattern.fps, pattern.speed);
+
+        const std::vector<fixed_step_run::TrailPoint> &trail = run.trail();
+        const bool same = run.finished() && run.steps() == reference.steps() && trail.size() == reference.trail().size() &&
+                          std::memcmp(trail.data(), reference.trail().data(), trail.size() * sizeof(trail[0])) == 0;
+        if (!CHECK(same))
+            std::cerr << "  " << pattern.fps << " FPS at " << pattern.speed << "x" << (pattern.jitter ? " with jitter" : "") << " differs\n";
+    }
+}
+
+const register_test TRAJECTORY_END {"trajectory_end", test_trajectory_end};
+const register_test FIXED_STEP_FRAME_RATES {"fixed_step_frame_rates", test_fixed_step_frame_rates};